@@ -0,0 +1,61 @@
+#include "AgentBatch.h"
+#include "CollisionKernel.h"
+#include <algorithm>
+
+void AgentBatch::resize(int count)
+{
+    x.resize(count);
+    y.resize(count);
+    dy.resize(count);
+    landings.resize(count);
+    alive.resize(count);
+    landedSlot.resize(count);
+    reset();
+}
+
+void AgentBatch::reset()
+{
+    std::fill(x.begin(), x.end(), WINDOW_WIDTH / 2);
+    std::fill(y.begin(), y.end(), WINDOW_HEIGHT - 80 - PLAYER_HEIGHT);
+    std::fill(dy.begin(), dy.end(), 0.0f);
+    std::fill(landings.begin(), landings.end(), 0);
+    std::fill(alive.begin(), alive.end(), (unsigned char)1);
+}
+
+void AgentBatch::step(const PlatformRing &field, const GameInput *inputs, const GameParams &params)
+{
+    int count = size();
+
+    // Movement and gravity, written branch-free so the compiler can vectorize it
+    for (int i = 0; i < count; i++)
+    {
+        int move = ((int)inputs[i].right - (int)inputs[i].left) * params.playerSpeed * alive[i];
+        x[i] = std::clamp(x[i] + move, SCREEN_BOUNDARY_LEFT, SCREEN_BOUNDARY_RIGHT);
+        float newDy = dy[i] + params.gravity;
+        dy[i] = alive[i] ? newDy : 0.0f;
+        y[i] += (int)dy[i];
+    }
+
+    findLandings(field.xs, field.ys, PLATFORM_CAPACITY, x.data(), y.data(), dy.data(), count, landedSlot.data());
+
+    for (int i = 0; i < count; i++)
+    {
+        if (landedSlot[i] >= 0)
+        {
+            // Bounce from the platform top, as the player does
+            y[i] = field.ys[landedSlot[i]] - PLAYER_HEIGHT;
+            dy[i] = -params.jumpPower;
+            landings[i]++;
+        }
+        if (y[i] > WINDOW_HEIGHT)
+            alive[i] = 0;
+    }
+}
+
+void AgentBatch::scroll(int amount)
+{
+    if (amount == 0)
+        return;
+    for (int &agentY : y)
+        agentY += amount;
+}
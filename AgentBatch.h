@@ -0,0 +1,34 @@
+#pragma once
+#include "GameSim.h"
+#include <vector>
+
+// A batch of lightweight simulated players ("ghosts") sharing one platform field.
+// State is structure-of-arrays and landing tests go through the vectorized
+// collision kernel, so thousands of agents can step per frame. Ghosts start, bounce
+// and die like the player but move in whole pixels (see CollisionKernel.h), so their
+// arcs drift slightly from the player's; they never move the camera, the field
+// owner scrolls them.
+struct AgentBatch
+{
+    std::vector<int> x, y;
+    std::vector<float> dy;
+    std::vector<int> landings;
+    std::vector<unsigned char> alive;
+
+    explicit AgentBatch(int count = 0) { resize(count); }
+
+    void resize(int count);
+    int size() const { return (int)x.size(); }
+
+    // Respawn every agent at the player start position
+    void reset();
+
+    // Advance every live agent by one tick against the shared platform field
+    void step(const PlatformRing &field, const GameInput *inputs, const GameParams &params);
+
+    // Shift agents down by the field's camera scroll for this tick
+    void scroll(int amount);
+
+private:
+    std::vector<int> landedSlot;
+};
@@ -0,0 +1,289 @@
+#include "AssetArchive.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char ARCHIVE_MAGIC[4] = {'D', 'J', 'P', 'K'};
+
+    // Payloads start on 16-byte boundaries
+    const std::uint64_t PAYLOAD_ALIGNMENT = 16;
+
+    // Bounds-checked little-endian reader over the mapped bytes
+    struct ByteReader
+    {
+        const std::uint8_t *data;
+        std::size_t size;
+        std::size_t position = 0;
+
+        bool read(void *out, std::size_t count)
+        {
+            if (count > size - position)
+                return false;
+            std::memcpy(out, data + position, count);
+            position += count;
+            return true;
+        }
+
+        template <typename T>
+        bool readInt(T &value)
+        {
+            std::uint8_t bytes[sizeof(T)];
+            if (!read(bytes, sizeof(T)))
+                return false;
+            value = 0;
+            for (std::size_t i = 0; i < sizeof(T); i++)
+                value |= (T)bytes[i] << (8 * i);
+            return true;
+        }
+    };
+
+    template <typename T>
+    void writeInt(std::ofstream &file, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); i++)
+            file.put((char)((value >> (8 * i)) & 0xFF));
+    }
+
+    bool readWholeFile(const std::string &path, std::vector<std::uint8_t> &bytes)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !file.bad();
+    }
+}
+
+AssetArchive::~AssetArchive()
+{
+    close();
+}
+
+void AssetArchive::close()
+{
+#ifdef _WIN32
+    if (base && mappingHandle)
+        UnmapViewOfFile(base);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (base && fileDescriptor >= 0)
+        munmap((void *)base, length);
+    if (fileDescriptor >= 0)
+        ::close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+    base = nullptr;
+    length = 0;
+    looseData.clear();
+    toc.clear();
+}
+
+bool AssetArchive::open(const std::string &path, std::string &error)
+{
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        fileHandle = nullptr;
+        error = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        error = "cannot read size of " + path;
+        close();
+        return false;
+    }
+    length = (std::size_t)fileSize.QuadPart;
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    base = mappingHandle ? (const std::uint8_t *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+    fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fileDescriptor, &info) != 0 || info.st_size == 0)
+    {
+        error = "cannot read size of " + path;
+        close();
+        return false;
+    }
+    length = (std::size_t)info.st_size;
+    void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    base = mapped == MAP_FAILED ? nullptr : (const std::uint8_t *)mapped;
+    if (base)
+    {
+        // Start paging the payloads in while the table of contents is parsed
+        madvise(mapped, length, MADV_WILLNEED);
+    }
+#endif
+
+    if (!base)
+    {
+        error = "cannot memory-map " + path;
+        close();
+        return false;
+    }
+
+    ByteReader reader{base, length};
+    char magic[4];
+    std::uint32_t version = 0, count = 0;
+    if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) != 0)
+    {
+        error = path + " is not an asset archive";
+        close();
+        return false;
+    }
+    if (!reader.readInt(version) || version != ASSET_ARCHIVE_VERSION || !reader.readInt(count))
+    {
+        error = path + " has an unsupported archive version";
+        close();
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        std::uint16_t nameLength = 0;
+        AssetEntry entry;
+        if (!reader.readInt(nameLength))
+        {
+            error = path + " has a truncated table of contents";
+            close();
+            return false;
+        }
+        entry.name.resize(nameLength);
+        if (!reader.read(entry.name.data(), nameLength) || !reader.readInt(entry.offset) || !reader.readInt(entry.size))
+        {
+            error = path + " has a truncated table of contents";
+            close();
+            return false;
+        }
+        if (entry.offset > length || entry.size > length - entry.offset)
+        {
+            error = path + ": entry " + entry.name + " points outside the archive";
+            close();
+            return false;
+        }
+        toc.push_back(entry);
+    }
+    return true;
+}
+
+bool AssetArchive::openLoose(const std::vector<std::string> &names, std::string &error)
+{
+    close();
+
+    // Concatenate the files into one buffer so lookups work exactly as with a mapped archive
+    for (const std::string &name : names)
+    {
+        std::vector<std::uint8_t> bytes;
+        if (!readWholeFile(name, bytes))
+        {
+            error = "cannot read " + name;
+            close();
+            return false;
+        }
+        toc.push_back(AssetEntry{name, looseData.size(), bytes.size()});
+        looseData.insert(looseData.end(), bytes.begin(), bytes.end());
+    }
+    base = looseData.data();
+    length = looseData.size();
+    return true;
+}
+
+const std::uint8_t *AssetArchive::find(const std::string &name, std::size_t &size) const
+{
+    for (const AssetEntry &entry : toc)
+    {
+        if (entry.name == name)
+        {
+            size = (std::size_t)entry.size;
+            return base + entry.offset;
+        }
+    }
+    size = 0;
+    return nullptr;
+}
+
+bool writeAssetArchive(const std::string &path, const std::vector<std::string> &files, std::string &error)
+{
+    std::vector<std::vector<std::uint8_t>> payloads(files.size());
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        if (!readWholeFile(files[i], payloads[i]))
+        {
+            error = "cannot read " + files[i];
+            return false;
+        }
+    }
+
+    // Lay out the table of contents first, then aligned payloads
+    std::uint64_t offset = sizeof(ARCHIVE_MAGIC) + 4 + 4;
+    for (const std::string &name : files)
+    {
+        offset += 2 + name.size() + 8 + 8;
+    }
+    std::vector<std::uint64_t> offsets(files.size());
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        offset = (offset + PAYLOAD_ALIGNMENT - 1) / PAYLOAD_ALIGNMENT * PAYLOAD_ALIGNMENT;
+        offsets[i] = offset;
+        offset += payloads[i].size();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        error = "cannot create " + path;
+        return false;
+    }
+
+    file.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    writeInt<std::uint32_t>(file, ASSET_ARCHIVE_VERSION);
+    writeInt<std::uint32_t>(file, (std::uint32_t)files.size());
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        writeInt<std::uint16_t>(file, (std::uint16_t)files[i].size());
+        file.write(files[i].data(), (std::streamsize)files[i].size());
+        writeInt<std::uint64_t>(file, offsets[i]);
+        writeInt<std::uint64_t>(file, payloads[i].size());
+    }
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        while ((std::uint64_t)file.tellp() < offsets[i])
+            file.put(0);
+        file.write((const char *)payloads[i].data(), (std::streamsize)payloads[i].size());
+    }
+
+    if (!file.good())
+    {
+        error = "failed writing " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Assets the game actually loads. Asset_Packer packs exactly these by default,
+// so unused files in images/ never reach the shipped bundle.
+const char *const ASSET_BACKGROUND = "images/background.png";
+const char *const ASSET_PLATFORM = "images/platform.png";
+const char *const ASSET_PLAYER = "images/doodle.png";
+const char *const ASSET_RESUME = "images/resume.png";
+const char *const ASSET_FONT = "images/font.otf";
+const char *const GAME_ASSET_FILES[] = {ASSET_BACKGROUND, ASSET_PLATFORM, ASSET_PLAYER, ASSET_RESUME, ASSET_FONT};
+
+const char *const ASSET_ARCHIVE_PATH = "assets.pak";
+
+// Single-file asset archive with a table of contents, memory-mapped read-only.
+//
+// Layout (little endian):
+//   "DJPK"  magic
+//   u32     format version (ASSET_ARCHIVE_VERSION)
+//   u32     entry count
+//   entries repeated { u16 name length, name bytes, u64 offset, u64 size }
+//   data    entry payloads at the recorded offsets
+const std::uint32_t ASSET_ARCHIVE_VERSION = 1;
+
+struct AssetEntry
+{
+    std::string name;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+class AssetArchive
+{
+public:
+    AssetArchive() = default;
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive &) = delete;
+    AssetArchive &operator=(const AssetArchive &) = delete;
+
+    // Map an archive file and validate its table of contents
+    bool open(const std::string &path, std::string &error);
+
+    // Fallback for development trees without a packed archive: read loose files into memory
+    bool openLoose(const std::vector<std::string> &names, std::string &error);
+
+    // Bytes of a named asset, valid for the archive's lifetime; nullptr if absent
+    const std::uint8_t *find(const std::string &name, std::size_t &size) const;
+
+    const std::vector<AssetEntry> &entries() const { return toc; }
+
+private:
+    void close();
+
+    const std::uint8_t *base = nullptr;
+    std::size_t length = 0;
+    std::vector<std::uint8_t> looseData;
+    std::vector<AssetEntry> toc;
+
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+};
+
+// Write an archive containing the given files. Used by the Asset_Packer tool.
+bool writeAssetArchive(const std::string &path, const std::vector<std::string> &files, std::string &error);
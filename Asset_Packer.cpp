@@ -0,0 +1,45 @@
+#include "AssetArchive.h"
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Packs game assets into a single memory-mappable archive.
+//
+// Usage: asset_packer [output.pak] [file ...]
+// With no files, packs the assets the game loads (GAME_ASSET_FILES) into assets.pak.
+// Run it from the repository root so the stored names match the game's lookups.
+
+int main(int argc, char **argv)
+{
+    std::string output = argc > 1 ? argv[1] : ASSET_ARCHIVE_PATH;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++)
+    {
+        files.push_back(argv[i]);
+    }
+    if (files.empty())
+    {
+        files.assign(std::begin(GAME_ASSET_FILES), std::end(GAME_ASSET_FILES));
+    }
+
+    std::string error;
+    if (!writeAssetArchive(output, files, error))
+    {
+        std::cerr << "asset_packer: " << error << "\n";
+        return 1;
+    }
+
+    AssetArchive archive;
+    if (!archive.open(output, error))
+    {
+        std::cerr << "asset_packer: wrote an unreadable archive: " << error << "\n";
+        return 1;
+    }
+    for (const AssetEntry &entry : archive.entries())
+    {
+        std::cout << entry.name << " " << entry.size << " bytes\n";
+    }
+    std::cout << "Packed " << archive.entries().size() << " assets into " << output << "\n";
+    return 0;
+}
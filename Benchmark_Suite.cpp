@@ -0,0 +1,552 @@
+#include "GameSim.h"
+#include "Policies.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARK_NO_RENDER
+#include <SFML/Graphics.hpp>
+#include "AssetArchive.h"
+#include "GameScreens.h"
+#include <iterator>
+#endif
+
+// Micro-benchmarks of the simulation hot paths and macro-benchmarks that render
+// every game screen offscreen. Results are printed as a table and can be written
+// as JSON and compared against a stored baseline; the exit code is 1 if any
+// benchmark got slower than the baseline by more than the threshold.
+//
+// Usage: benchmark_suite [--filter=TEXT] [--frames=N] [--out=results.json]
+//                        [--baseline=baseline.json] [--threshold=PERCENT]
+//
+// Build with -DBENCHMARK_NO_RENDER to leave out the render benchmarks and SFML,
+// for build servers without a GPU.
+
+// Timed runs per benchmark; the median is compared, the minimum shown for reference
+const int BENCHMARK_RUNS = 9;
+
+// Micro-benchmarks double their operation count until one run takes at least this long
+const double MIN_RUN_SECONDS = 0.02;
+
+// Simulated ticks recorded for the micro-benchmarks to replay
+const int TRAJECTORY_TICKS = 20000;
+
+// Live particles kept up for render_particles
+const int PARTICLE_BENCHMARK_LIVE = 10000;
+
+struct BenchmarkResult
+{
+    std::string name;
+    double medianNs = 0; // Per operation
+    double minNs = 0;
+    long long ops = 0;   // Operations per run
+};
+
+// Keeps the optimizer from discarding benchmarked work
+volatile long long benchmarkSink = 0;
+
+using Clock = std::chrono::steady_clock;
+
+// Time BENCHMARK_RUNS calls of body(ops). With calibrate set, ops is first doubled
+// until a single run is long enough to time reliably.
+BenchmarkResult measure(const std::string &name, long long ops, bool calibrate, const std::function<void(long long)> &body)
+{
+    auto timeRun = [&]()
+    {
+        Clock::time_point start = Clock::now();
+        body(ops);
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    // Warm caches and lazily created resources
+    double seconds = timeRun();
+    while (calibrate && seconds < MIN_RUN_SECONDS)
+    {
+        ops *= 2;
+        seconds = timeRun();
+    }
+
+    std::vector<double> perOp;
+    for (int run = 0; run < BENCHMARK_RUNS; run++)
+    {
+        perOp.push_back(timeRun() * 1e9 / ops);
+    }
+    std::sort(perOp.begin(), perOp.end());
+
+    BenchmarkResult result;
+    result.name = name;
+    result.medianNs = perOp[perOp.size() / 2];
+    result.minNs = perOp.front();
+    result.ops = ops;
+    return result;
+}
+
+// Scripted-policy play recorded tick by tick, so every run of a benchmark sees
+// the same sequence of states. Games that end are followed by a new seed.
+struct Trajectory
+{
+    std::vector<SimState> before;    // State at the start of each tick
+    std::vector<SimState> afterMove; // State after movePlayer, before scrollCamera
+    std::vector<GameInput> inputs;
+    std::vector<bool> gameStart;     // Tick is the first of a game
+};
+
+Trajectory recordTrajectory(int ticks)
+{
+    Trajectory trajectory;
+    GameSim sim(1);
+    std::uint64_t seed = 1;
+    bool starting = true;
+    SimState state;
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        if (sim.gameOver)
+        {
+            sim.reset(++seed);
+            starting = true;
+        }
+        GameInput input = scriptedPolicy(sim);
+        sim.snapshot(state);
+        trajectory.before.push_back(state);
+        trajectory.inputs.push_back(input);
+        trajectory.gameStart.push_back(starting);
+        starting = false;
+
+        sim.movePlayer(input);
+        sim.snapshot(state);
+        trajectory.afterMove.push_back(state);
+        sim.scrollCamera();
+    }
+    return trajectory;
+}
+
+// Rolling back a game with custom params must keep those params and replay the
+// same run; benchmarks that restore trajectory states into such a game rely on it
+bool checkRollback()
+{
+    GameParams params;
+    params.platformSpacing += 7;
+    params.minPlatforms++;
+    GameSim original(7, params);
+    for (int tick = 0; tick < 300 && !original.gameOver; tick++)
+        original.step(scriptedPolicy(original));
+
+    SimState saved;
+    original.snapshot(saved);
+    std::vector<GameInput> inputs;
+    for (int tick = 0; tick < 1200 && !original.gameOver; tick++)
+    {
+        inputs.push_back(scriptedPolicy(original));
+        original.step(inputs.back());
+    }
+
+    // Start the rewound game from a default-params game's state first, the way the
+    // custom benchmarks restore trajectory states, so stale params cannot ride along
+    SimState foreign;
+    GameSim(99).snapshot(foreign);
+    GameSim rewound(99, params);
+    for (const SimState *state : {&foreign, &saved})
+    {
+        rewound.restore(*state);
+        if (rewound.params.platformSpacing != params.platformSpacing || rewound.params.minPlatforms != params.minPlatforms)
+        {
+            std::cerr << "Rollback check failed: restore overwrote GameParams" << std::endl;
+            return false;
+        }
+    }
+    for (const GameInput &input : inputs)
+        rewound.step(input);
+    if (rewound.x != original.x || rewound.y != original.y || rewound.dy != original.dy ||
+        rewound.currentScore != original.currentScore || rewound.heightClimbed != original.heightClimbed ||
+        rewound.gapsSpawned != original.gapsSpawned || rewound.gameOver != original.gameOver)
+    {
+        std::cerr << "Rollback check failed: rewound game diverged from the original" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void runMicroBenchmarks(const Trajectory &trajectory, std::vector<BenchmarkResult> &results, const std::function<bool(const char *)> &selected)
+{
+    const size_t ticks = trajectory.inputs.size();
+    GameSim sim;
+
+    // Whole ticks played in order, rewinding only where the recording started a new game.
+    // Runs longer than the recording wrap around to its start, which is also a game start.
+    if (selected("sim_step"))
+    {
+        results.push_back(measure("sim_step", 1024, true, [&](long long ops)
+                                  {
+            size_t t = 0;
+            for (long long i = 0; i < ops; i++)
+            {
+                if (trajectory.gameStart[t])
+                    sim.restore(trajectory.before[t]);
+                sim.step(trajectory.inputs[t]);
+                t = t + 1 < ticks ? t + 1 : 0;
+            }
+            benchmarkSink = sim.currentScore; }));
+    }
+
+    // The halves of a tick need their own starting state each time; state_restore
+    // times that copy alone so it can be subtracted from the two below
+    if (selected("state_restore"))
+    {
+        results.push_back(measure("state_restore", 1024, true, [&](long long ops)
+                                  {
+            size_t t = 0;
+            long long sum = 0;
+            for (long long i = 0; i < ops; i++)
+            {
+                sim.restore(trajectory.before[t]);
+                sum += sim.y;
+                t = t + 1 < ticks ? t + 1 : 0;
+            }
+            benchmarkSink = sum; }));
+    }
+
+    // Movement, gravity and the platform landing loop
+    if (selected("move_player"))
+    {
+        results.push_back(measure("move_player", 1024, true, [&](long long ops)
+                                  {
+            size_t t = 0;
+            long long sum = 0;
+            for (long long i = 0; i < ops; i++)
+            {
+                sim.restore(trajectory.before[t]);
+                sim.movePlayer(trajectory.inputs[t]);
+                sum += sim.currentScore;
+                t = t + 1 < ticks ? t + 1 : 0;
+            }
+            benchmarkSink = sum; }));
+    }
+
+    // The same through the update that reads GameParams every tick, as tuning runs with
+    // custom params use; physics are unchanged, so this prices the mode specialization
+    if (selected("move_player_custom"))
+    {
+        GameSim custom;
+        GameParams params = custom.params;
+        params.platformSpacing++;
+        custom.setParams(params);
+        results.push_back(measure("move_player_custom", 1024, true, [&](long long ops)
+                                  {
+            size_t t = 0;
+            long long sum = 0;
+            for (long long i = 0; i < ops; i++)
+            {
+                custom.restore(trajectory.before[t]);
+                custom.movePlayer(trajectory.inputs[t]);
+                sum += custom.currentScore;
+                t = t + 1 < ticks ? t + 1 : 0;
+            }
+            benchmarkSink = sum; }));
+        // Restoring the default-params trajectory must not have reset the custom params,
+        // or this would have timed the specialized kernel again
+        assert(custom.params.platformSpacing != GameParams().platformSpacing);
+    }
+
+    // Camera scroll with platform recycling and respawn, on the ticks where the camera moves
+    if (selected("scroll_camera"))
+    {
+        std::vector<const SimState *> scrolling;
+        for (const SimState &state : trajectory.afterMove)
+        {
+            if (state.peakY < CAMERA_THRESHOLD)
+                scrolling.push_back(&state);
+        }
+        results.push_back(measure("scroll_camera", 1024, true, [&](long long ops)
+                                  {
+            size_t t = 0;
+            long long sum = 0;
+            for (long long i = 0; i < ops; i++)
+            {
+                sim.restore(*scrolling[t]);
+                sim.scrollCamera();
+                sum += sim.platforms.top().y;
+                t = t + 1 < scrolling.size() ? t + 1 : 0;
+            }
+            benchmarkSink = sum; }));
+    }
+
+    // One screen of level with its reachability checks, as the level streamer makes it
+    if (selected("generate_chunk"))
+    {
+        results.push_back(measure("generate_chunk", 64, true, [&](long long ops)
+                                  {
+            long long sum = 0;
+            for (long long i = 0; i < ops; i++)
+            {
+                LevelChunk chunk = generateChunk(sim.levelSeed, (int)(i & 1023), sim.params);
+                sum += chunk.count;
+            }
+            benchmarkSink = sum; }));
+    }
+
+    // Laying out a fresh platform field for a new game
+    if (selected("reset"))
+    {
+        results.push_back(measure("reset", 1024, true, [&](long long ops)
+                                  {
+            long long sum = 0;
+            for (long long i = 0; i < ops; i++)
+            {
+                sim.reset((std::uint64_t)i + 1);
+                sum += sim.platforms.top().x;
+            }
+            benchmarkSink = sum; }));
+    }
+}
+
+#ifndef BENCHMARK_NO_RENDER
+// Render every screen into an offscreen texture, through the same GameScreens code the game draws with
+bool runRenderBenchmarks(const Trajectory &trajectory, int frames, std::vector<BenchmarkResult> &results, const std::function<bool(const char *)> &selected)
+{
+    AssetArchive archive;
+    std::string error;
+    if (!archive.open(ASSET_ARCHIVE_PATH, error) &&
+        !archive.openLoose(std::vector<std::string>(std::begin(GAME_ASSET_FILES), std::end(GAME_ASSET_FILES)), error))
+    {
+        std::cerr << "Cannot load assets for render benchmarks: " << error << "\n";
+        return false;
+    }
+
+    // The render texture owns the GL context the atlas uploads into, so it comes first
+    sf::RenderTexture target;
+    if (!target.resize(sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)))
+    {
+        std::cerr << "Cannot create a render texture for render benchmarks\n";
+        return false;
+    }
+
+    TextureAtlas atlas;
+    if (!decodeAtlas(archive, atlas, error) || !atlas.upload())
+    {
+        std::cerr << "Cannot build the texture atlas: " << (error.empty() ? "upload failed" : error) << "\n";
+        return false;
+    }
+
+    sf::Font font;
+    std::size_t fontSize = 0;
+    const std::uint8_t *fontData = archive.find(ASSET_FONT, fontSize);
+    if (!fontData || !font.openFromMemory(fontData, fontSize))
+    {
+        std::cerr << "Cannot open font " << ASSET_FONT << "\n";
+        return false;
+    }
+
+    GameScreens screens(font, atlas);
+    screens.atlasUploaded();
+    screens.setLeaderboard("1.  412\n2.  388\n3.  251\n4.  170\n5.  96");
+    screens.setRank(3);
+
+    // Snapshots of the recorded play, so the playing screen draws real platform layouts
+    std::vector<SimSnapshot> snapshots(std::min<size_t>(trajectory.afterMove.size(), 1024));
+    GameSim sim;
+    for (size_t i = 0; i < snapshots.size(); i++)
+    {
+        sim.restore(trajectory.before[i]);
+        sim.step(trajectory.inputs[i]);
+        snapshots[i].capture(sim);
+    }
+
+    const struct
+    {
+        const char *name;
+        GameState state;
+        bool cached; // Drawn the way the game draws static screens
+    } screenStates[] = {{"render_menu", MENU, false}, {"render_playing", PLAYING, false}, {"render_paused", PAUSED, false},
+                        {"render_game_over", GAME_OVER, false}, {"render_menu_cached", MENU, true},
+                        {"render_paused_cached", PAUSED, true}, {"render_game_over_cached", GAME_OVER, true}};
+
+    for (const auto &screen : screenStates)
+    {
+        if (!selected(screen.name))
+            continue;
+
+        results.push_back(measure(screen.name, frames, false, [&](long long ops)
+                                  {
+            ScreenView view;
+            view.state = screen.state;
+            view.bestScore = 412;
+            for (long long i = 0; i < ops; i++)
+            {
+                view.snapshot = &snapshots[screen.state == PLAYING ? i % snapshots.size() : snapshots.size() / 2];
+                view.alpha = (i % 4) * 0.25f;
+                if (screen.cached)
+                    screens.drawCached(target, view);
+                else
+                    screens.draw(target, view);
+                target.display();
+            }
+
+            // Drawing is queued on the GPU; reading the result back waits for all of it
+            benchmarkSink = target.getTexture().copyToImage().getSize().x; }));
+    }
+
+    // The playing screen with PARTICLE_BENCHMARK_LIVE effect particles updated and drawn every frame
+    if (selected("render_particles"))
+    {
+        const ParticleBurst burst{500, sf::Color(255, 210, 60), 600, -1.5707964f, 3.1415927f, 1.0f, 4};
+        ParticlePool particles;
+        results.push_back(measure("render_particles", frames, false, [&](long long ops)
+                                  {
+            ScreenView view;
+            view.state = PLAYING;
+            for (long long i = 0; i < ops; i++)
+            {
+                while (particles.size() < PARTICLE_BENCHMARK_LIVE)
+                    particles.emit(sf::Vector2f(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2), burst);
+                particles.update((float)TICK_SECONDS);
+
+                view.snapshot = &snapshots[i % snapshots.size()];
+                screens.draw(target, view);
+                particles.draw(target);
+                target.display();
+            }
+            benchmarkSink = target.getTexture().copyToImage().getSize().x; }));
+    }
+    return true;
+}
+#endif
+
+// Median per benchmark from a file written with --out. Each benchmark is on its own line.
+bool loadBaseline(const std::string &path, std::vector<BenchmarkResult> &baseline)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        size_t name = line.find("\"name\": \"");
+        size_t median = line.find("\"ns_per_op\": ");
+        if (name == std::string::npos || median == std::string::npos)
+            continue;
+
+        BenchmarkResult result;
+        name += 9;
+        result.name = line.substr(name, line.find('"', name) - name);
+        result.medianNs = std::atof(line.c_str() + median + 13);
+        baseline.push_back(result);
+    }
+    return true;
+}
+
+bool writeResults(const std::string &path, const std::vector<BenchmarkResult> &results)
+{
+    std::ofstream file(path);
+    file << "{\n  \"runs\": " << BENCHMARK_RUNS << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &result = results[i];
+        file << "    {\"name\": \"" << result.name << "\", \"ns_per_op\": " << result.medianNs
+             << ", \"min_ns_per_op\": " << result.minNs << ", \"ops\": " << result.ops << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return (bool)file;
+}
+
+int main(int argc, char **argv)
+{
+    std::string filter;
+    std::string outputPath;
+    std::string baselinePath;
+    double thresholdPercent = 10.0;
+    int frames = 600;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--filter=", 9) == 0)
+            filter = argv[i] + 9;
+        else if (std::strncmp(argv[i], "--out=", 6) == 0)
+            outputPath = argv[i] + 6;
+        else if (std::strncmp(argv[i], "--baseline=", 11) == 0)
+            baselinePath = argv[i] + 11;
+        else if (std::strncmp(argv[i], "--threshold=", 12) == 0)
+            thresholdPercent = std::atof(argv[i] + 12);
+        else if (std::strncmp(argv[i], "--frames=", 9) == 0)
+            frames = std::max(1, std::atoi(argv[i] + 9));
+    }
+
+    auto selected = [&](const char *name)
+    {
+        return filter.empty() || std::string(name).find(filter) != std::string::npos;
+    };
+
+    if (!checkRollback())
+        return 1;
+
+    Trajectory trajectory = recordTrajectory(TRAJECTORY_TICKS);
+
+    std::vector<BenchmarkResult> results;
+    runMicroBenchmarks(trajectory, results, selected);
+#ifndef BENCHMARK_NO_RENDER
+    if (!runRenderBenchmarks(trajectory, frames, results, selected))
+        return 1;
+#else
+    (void)frames;
+#endif
+
+    std::vector<BenchmarkResult> baseline;
+    if (!baselinePath.empty() && !loadBaseline(baselinePath, baseline))
+    {
+        std::cerr << "Cannot read baseline " << baselinePath << "\n";
+        return 1;
+    }
+
+    std::cout << "benchmark,ns_per_op,min_ns_per_op,ops";
+    if (!baseline.empty())
+        std::cout << ",baseline_ns_per_op,change_percent,status";
+    std::cout << "\n";
+
+    int regressions = 0;
+    for (const BenchmarkResult &result : results)
+    {
+        std::cout << result.name << "," << result.medianNs << "," << result.minNs << "," << result.ops;
+        auto previous = std::find_if(baseline.begin(), baseline.end(), [&](const BenchmarkResult &b)
+                                     { return b.name == result.name; });
+        if (previous != baseline.end() && previous->medianNs > 0)
+        {
+            double change = (result.medianNs / previous->medianNs - 1.0) * 100.0;
+            const char *status = "ok";
+            if (change > thresholdPercent)
+            {
+                status = "REGRESSION";
+                regressions++;
+            }
+            else if (change < -thresholdPercent)
+            {
+                status = "improved";
+            }
+            std::cout << "," << previous->medianNs << "," << change << "," << status;
+        }
+        else if (!baseline.empty())
+        {
+            std::cout << ",,,new";
+        }
+        std::cout << "\n";
+    }
+
+    if (!outputPath.empty() && !writeResults(outputPath, results))
+    {
+        std::cerr << "Could not write results to " << outputPath << "\n";
+        return 1;
+    }
+
+    if (regressions > 0)
+    {
+        std::cerr << regressions << " benchmark(s) slower than the baseline by more than " << thresholdPercent << "%\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "CollisionKernel.h"
+#include "GameSim.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLLISION_KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_KERNEL_SSE2
+#endif
+
+void findLandingsScalar(const int *platformX, const int *platformY, int platformSlots,
+                        const int *agentX, const int *agentY, const float *agentDy, int agentCount,
+                        int *landedSlot)
+{
+    for (int a = 0; a < agentCount; a++)
+    {
+        landedSlot[a] = -1;
+        if (!(agentDy[a] > 0))
+            continue;
+
+        int center = agentX[a] + PLAYER_WIDTH / 2;
+        int feet = agentY[a] + PLAYER_HEIGHT;
+        int startFeet = feet - (int)agentDy[a];
+        for (int p = 0; p < platformSlots; p++)
+        {
+            if (center > platformX[p] && center < platformX[p] + PLATFORM_WIDTH &&
+                startFeet <= platformY[p] && platformY[p] <= feet)
+            {
+                landedSlot[a] = p;
+                break;
+            }
+        }
+    }
+}
+
+#if defined(COLLISION_KERNEL_AVX2)
+
+const char *collisionKernelIsa()
+{
+    return "AVX2";
+}
+
+void findLandings(const int *platformX, const int *platformY, int platformSlots,
+                  const int *agentX, const int *agentY, const float *agentDy, int agentCount,
+                  int *landedSlot)
+{
+    const __m256i halfWidth = _mm256_set1_epi32(PLAYER_WIDTH / 2);
+    const __m256i height = _mm256_set1_epi32(PLAYER_HEIGHT);
+    const __m256i none = _mm256_set1_epi32(-1);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int a = 0;
+    for (; a + 8 <= agentCount; a += 8)
+    {
+        __m256i center = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(agentX + a)), halfWidth);
+        __m256i feet = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(agentY + a)), height);
+        __m256 dy = _mm256_loadu_ps(agentDy + a);
+        __m256i startFeet = _mm256_sub_epi32(feet, _mm256_cvttps_epi32(dy));
+        __m256i falling = _mm256_castps_si256(_mm256_cmp_ps(dy, zero, _CMP_GT_OQ));
+
+        // Walk platforms from the last slot down so the lowest matching slot wins, as in the scalar loop
+        __m256i result = none;
+        for (int p = platformSlots - 1; p >= 0; p--)
+        {
+            __m256i left = _mm256_set1_epi32(platformX[p]);
+            __m256i right = _mm256_set1_epi32(platformX[p] + PLATFORM_WIDTH);
+            __m256i top = _mm256_set1_epi32(platformY[p]);
+
+            // Crossed unless the top lies above the start or below the end of the fall
+            __m256i missed = _mm256_or_si256(_mm256_cmpgt_epi32(startFeet, top), _mm256_cmpgt_epi32(top, feet));
+            __m256i hit = _mm256_andnot_si256(missed,
+                                              _mm256_and_si256(_mm256_cmpgt_epi32(center, left), _mm256_cmpgt_epi32(right, center)));
+            result = _mm256_blendv_epi8(result, _mm256_set1_epi32(p), hit);
+        }
+
+        result = _mm256_blendv_epi8(none, result, falling);
+        _mm256_storeu_si256((__m256i *)(landedSlot + a), result);
+    }
+
+    findLandingsScalar(platformX, platformY, platformSlots, agentX + a, agentY + a, agentDy + a, agentCount - a, landedSlot + a);
+}
+
+#elif defined(COLLISION_KERNEL_SSE2)
+
+const char *collisionKernelIsa()
+{
+    return "SSE2";
+}
+
+void findLandings(const int *platformX, const int *platformY, int platformSlots,
+                  const int *agentX, const int *agentY, const float *agentDy, int agentCount,
+                  int *landedSlot)
+{
+    const __m128i halfWidth = _mm_set1_epi32(PLAYER_WIDTH / 2);
+    const __m128i height = _mm_set1_epi32(PLAYER_HEIGHT);
+    const __m128i none = _mm_set1_epi32(-1);
+    const __m128 zero = _mm_setzero_ps();
+
+    int a = 0;
+    for (; a + 4 <= agentCount; a += 4)
+    {
+        __m128i center = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(agentX + a)), halfWidth);
+        __m128i feet = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(agentY + a)), height);
+        __m128 dy = _mm_loadu_ps(agentDy + a);
+        __m128i startFeet = _mm_sub_epi32(feet, _mm_cvttps_epi32(dy));
+        __m128i falling = _mm_castps_si128(_mm_cmpgt_ps(dy, zero));
+
+        // Walk platforms from the last slot down so the lowest matching slot wins, as in the scalar loop
+        __m128i result = none;
+        for (int p = platformSlots - 1; p >= 0; p--)
+        {
+            __m128i left = _mm_set1_epi32(platformX[p]);
+            __m128i right = _mm_set1_epi32(platformX[p] + PLATFORM_WIDTH);
+            __m128i top = _mm_set1_epi32(platformY[p]);
+
+            // Crossed unless the top lies above the start or below the end of the fall
+            __m128i missed = _mm_or_si128(_mm_cmpgt_epi32(startFeet, top), _mm_cmpgt_epi32(top, feet));
+            __m128i hit = _mm_andnot_si128(missed,
+                                           _mm_and_si128(_mm_cmpgt_epi32(center, left), _mm_cmplt_epi32(center, right)));
+
+            // SSE2 has no blend: select with and/andnot
+            result = _mm_or_si128(_mm_and_si128(hit, _mm_set1_epi32(p)), _mm_andnot_si128(hit, result));
+        }
+
+        result = _mm_or_si128(_mm_and_si128(falling, result), _mm_andnot_si128(falling, none));
+        _mm_storeu_si128((__m128i *)(landedSlot + a), result);
+    }
+
+    findLandingsScalar(platformX, platformY, platformSlots, agentX + a, agentY + a, agentDy + a, agentCount - a, landedSlot + a);
+}
+
+#else
+
+const char *collisionKernelIsa()
+{
+    return "scalar";
+}
+
+void findLandings(const int *platformX, const int *platformY, int platformSlots,
+                  const int *agentX, const int *agentY, const float *agentDy, int agentCount,
+                  int *landedSlot)
+{
+    findLandingsScalar(platformX, platformY, platformSlots, agentX, agentY, agentDy, agentCount, landedSlot);
+}
+
+#endif
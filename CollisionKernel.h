@@ -0,0 +1,26 @@
+#pragma once
+
+// Batched platform landing test, vectorized across agents (AVX2 or SSE2, with a
+// scalar fallback). For every falling agent it reports a platform slot whose top
+// edge the agent's feet crossed during the tick, between the feet before and after
+// the move, so fast falls cannot pass through a platform. This is GameSim's swept
+// test reduced to whole pixels: agents step their velocity truncated to an integer
+// and the horizontal check uses the end of the tick, not the moment of contact.
+// At the speeds agents reach on screen at most one platform top is crossed per tick.
+// Platform and agent data are structure-of-arrays; unused platform slots should
+// hold EMPTY_PLATFORM_Y so they never match.
+//
+// agentX/agentY are the player sprite's top-left corner after the move and
+// agentDy the velocity it moved with. landedSlot[i] receives the platform slot
+// index, or -1 if agent i does not land this tick.
+void findLandings(const int *platformX, const int *platformY, int platformSlots,
+                  const int *agentX, const int *agentY, const float *agentDy, int agentCount,
+                  int *landedSlot);
+
+// Scalar reference implementation, used for the tail of each batch
+void findLandingsScalar(const int *platformX, const int *platformY, int platformSlots,
+                        const int *agentX, const int *agentY, const float *agentDy, int agentCount,
+                        int *landedSlot);
+
+// Name of the instruction set findLandings was compiled for
+const char *collisionKernelIsa();
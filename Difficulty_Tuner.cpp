@@ -0,0 +1,218 @@
+#include "GameSim.h"
+#include "Policies.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Monte Carlo difficulty tuning: plays many seeded games for every combination
+// of the parameter grid across all cores and prints one CSV row per configuration.
+//
+// Usage: difficulty_tuner [--games=N] [--seed=S] [--policy=scripted|random|lookahead] [--threads=T]
+//                         [--max-ticks=N] [--gravity=a,b,..] [--jump-power=a,b,..]
+//                         [--spacing=a,b,..] [--min-platforms=a,b,..] [--difficulty-threshold=a,b,..]
+
+enum PolicyKind
+{
+    POLICY_SCRIPTED,
+    POLICY_RANDOM,
+    POLICY_LOOKAHEAD
+};
+
+struct GameResult
+{
+    int score = 0;
+    int deathHeight = 0;
+    int gapsSpawned = 0;
+    int unreachableGaps = 0;
+    bool hitTickLimit = false;
+};
+
+template <typename T>
+std::vector<T> parseList(const char *text)
+{
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        std::stringstream itemStream(item);
+        T value;
+        if (itemStream >> value)
+            values.push_back(value);
+    }
+    return values;
+}
+
+// Seeds are derived from the base seed and game index only, so results do not depend on scheduling
+std::uint64_t gameSeed(std::uint64_t baseSeed, int gameIndex, std::uint64_t stream)
+{
+    Rng mixer;
+    mixer.seed(baseSeed * 0x9E3779B97F4A7C15ULL + (std::uint64_t)gameIndex * 2 + stream);
+    return ((std::uint64_t)mixer.next() << 32) | mixer.next();
+}
+
+int percentile(const std::vector<int> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+int main(int argc, char **argv)
+{
+    int gamesPerConfig = 2000;
+    std::uint64_t baseSeed = 1;
+    PolicyKind policy = POLICY_SCRIPTED;
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    int maxTicks = 100000;
+
+    std::vector<float> gravities = {GRAVITY};
+    std::vector<float> jumpPowers = {JUMP_POWER};
+    std::vector<int> spacings = {PLATFORM_SPACING};
+    std::vector<int> minPlatforms = {MIN_PLATFORMS};
+    std::vector<int> thresholds = {DIFFICULTY_SCORE_THRESHOLD};
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        if (std::strncmp(arg, "--games=", 8) == 0)
+            gamesPerConfig = std::max(1, std::atoi(arg + 8));
+        else if (std::strncmp(arg, "--seed=", 7) == 0)
+            baseSeed = std::strtoull(arg + 7, nullptr, 10);
+        else if (std::strcmp(arg, "--policy=random") == 0)
+            policy = POLICY_RANDOM;
+        else if (std::strcmp(arg, "--policy=scripted") == 0)
+            policy = POLICY_SCRIPTED;
+        else if (std::strcmp(arg, "--policy=lookahead") == 0)
+            policy = POLICY_LOOKAHEAD;
+        else if (std::strncmp(arg, "--threads=", 10) == 0)
+            threadCount = (unsigned int)std::max(1, std::atoi(arg + 10));
+        else if (std::strncmp(arg, "--max-ticks=", 12) == 0)
+            maxTicks = std::max(1, std::atoi(arg + 12));
+        else if (std::strncmp(arg, "--gravity=", 10) == 0)
+            gravities = parseList<float>(arg + 10);
+        else if (std::strncmp(arg, "--jump-power=", 13) == 0)
+            jumpPowers = parseList<float>(arg + 13);
+        else if (std::strncmp(arg, "--spacing=", 10) == 0)
+            spacings = parseList<int>(arg + 10);
+        else if (std::strncmp(arg, "--min-platforms=", 16) == 0)
+            minPlatforms = parseList<int>(arg + 16);
+        else if (std::strncmp(arg, "--difficulty-threshold=", 23) == 0)
+            thresholds = parseList<int>(arg + 23);
+        else
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    // Expand the parameter grid
+    std::vector<GameParams> configs;
+    for (float gravity : gravities)
+        for (float jumpPower : jumpPowers)
+            for (int spacing : spacings)
+                for (int minCount : minPlatforms)
+                    for (int threshold : thresholds)
+                    {
+                        GameParams params;
+                        params.gravity = gravity;
+                        params.jumpPower = jumpPower;
+                        params.platformSpacing = spacing;
+                        params.minPlatforms = std::clamp(minCount, 1, PLATFORM_COUNT);
+                        params.difficultyScoreThreshold = std::max(1, threshold);
+                        configs.push_back(params);
+                    }
+
+    if (configs.empty())
+    {
+        std::cerr << "Parameter grid is empty\n";
+        return 1;
+    }
+
+    int totalGames = (int)configs.size() * gamesPerConfig;
+    std::vector<GameResult> results(totalGames);
+
+    std::cerr << "Running " << configs.size() << " configurations x " << gamesPerConfig
+              << " games on " << threadCount << " threads\n";
+    auto start = std::chrono::steady_clock::now();
+
+    ThreadPool pool(threadCount);
+    pool.parallelFor(totalGames, 16, [&](int begin, int end)
+                     {
+        for (int job = begin; job < end; job++)
+        {
+            int configIndex = job / gamesPerConfig;
+            int gameIndex = job % gamesPerConfig;
+
+            // Every configuration plays the same seeds so differences come from the params alone
+            GameSim sim(gameSeed(baseSeed, gameIndex, 0), configs[configIndex]);
+            RandomPolicy randomPolicy(gameSeed(baseSeed, gameIndex, 1));
+            LookaheadPolicy lookaheadPolicy;
+
+            int ticks = 0;
+            while (!sim.gameOver && ticks < maxTicks)
+            {
+                if (policy == POLICY_RANDOM)
+                    sim.step(randomPolicy.next());
+                else if (policy == POLICY_LOOKAHEAD)
+                    sim.step(lookaheadPolicy.next(sim));
+                else
+                    sim.step(scriptedPolicy(sim));
+                ticks++;
+            }
+
+            GameResult &result = results[job];
+            result.score = sim.currentScore;
+            result.deathHeight = sim.heightClimbed;
+            result.gapsSpawned = sim.gapsSpawned;
+            result.unreachableGaps = sim.unreachableGaps;
+            result.hitTickLimit = !sim.gameOver;
+        } });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Finished in " << seconds << " s\n";
+
+    std::cout << "gravity,jump_power,spacing,min_platforms,difficulty_threshold,games,"
+                 "score_mean,score_p10,score_p50,score_p90,score_max,"
+                 "death_height_mean,death_height_p50,unreachable_gap_share,tick_limited_games\n";
+
+    for (size_t configIndex = 0; configIndex < configs.size(); configIndex++)
+    {
+        const GameParams &params = configs[configIndex];
+        std::vector<int> scores;
+        std::vector<int> heights;
+        long long scoreSum = 0, heightSum = 0, gapSum = 0, unreachableSum = 0;
+        int tickLimited = 0;
+
+        for (int gameIndex = 0; gameIndex < gamesPerConfig; gameIndex++)
+        {
+            const GameResult &result = results[configIndex * gamesPerConfig + gameIndex];
+            scores.push_back(result.score);
+            heights.push_back(result.deathHeight);
+            scoreSum += result.score;
+            heightSum += result.deathHeight;
+            gapSum += result.gapsSpawned;
+            unreachableSum += result.unreachableGaps;
+            tickLimited += result.hitTickLimit ? 1 : 0;
+        }
+
+        std::sort(scores.begin(), scores.end());
+        std::sort(heights.begin(), heights.end());
+
+        std::cout << params.gravity << ',' << params.jumpPower << ',' << params.platformSpacing << ','
+                  << params.minPlatforms << ',' << params.difficultyScoreThreshold << ',' << gamesPerConfig << ','
+                  << (double)scoreSum / gamesPerConfig << ',' << percentile(scores, 0.1) << ','
+                  << percentile(scores, 0.5) << ',' << percentile(scores, 0.9) << ',' << scores.back() << ','
+                  << (double)heightSum / gamesPerConfig << ',' << percentile(heights, 0.5) << ','
+                  << (gapSum > 0 ? (double)unreachableSum / gapSum : 0.0) << ',' << tickLimited << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "DoodleEnv.h"
+#include "VecEnv.h"
+
+static_assert(DOODLE_ENV_LEFT == INPUT_LEFT && DOODLE_ENV_RIGHT == INPUT_RIGHT, "C action bits must match the input masks");
+
+struct DoodleEnv
+{
+    VecEnv env;
+
+    DoodleEnv(int count, uint64_t seed, unsigned int threads, int maxTicks) : env(count, seed, threads, maxTicks) {}
+};
+
+DoodleEnv *doodle_env_create(int count, uint64_t seed, int threads, int max_ticks)
+{
+    if (count <= 0)
+        return nullptr;
+    unsigned int threadCount = threads > 0 ? (unsigned int)threads : std::thread::hardware_concurrency();
+
+    // Exceptions must not cross the C boundary; failing to allocate or start threads returns null
+    try
+    {
+        return new DoodleEnv(count, seed, threadCount, max_ticks);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void doodle_env_destroy(DoodleEnv *env)
+{
+    delete env;
+}
+
+int doodle_env_count(const DoodleEnv *env)
+{
+    return env->env.size();
+}
+
+int doodle_env_obs_size(void)
+{
+    return ENV_OBS_SIZE;
+}
+
+void doodle_env_reset(DoodleEnv *env, const uint64_t *seeds, float *observations)
+{
+    env->env.reset(seeds, observations);
+}
+
+void doodle_env_reset_one(DoodleEnv *env, int index, uint64_t seed, float *observation)
+{
+    env->env.resetOne(index, seed, observation);
+}
+
+void doodle_env_step(DoodleEnv *env, const uint8_t *actions, float *observations, float *rewards, uint8_t *dones)
+{
+    env->env.step(actions, observations, rewards, dones);
+}
+
+int doodle_env_episode_score(const DoodleEnv *env, int index)
+{
+    return env->env.episodeScore(index);
+}
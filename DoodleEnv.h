@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// C interface to VecEnv, for loading the environment from Python (ctypes, cffi)
+// or any other language with a C FFI. Every buffer is owned by the caller and
+// laid out by environment index; nothing is allocated after doodle_env_create.
+//
+//   observations  count * doodle_env_obs_size() floats
+//   actions       count bytes of DOODLE_ENV_LEFT / DOODLE_ENV_RIGHT bits
+//   rewards       count floats (score gained this step)
+//   dones         count bytes, 1 where a game ended and was restarted
+
+#if defined(_WIN32)
+#define DOODLE_ENV_API __declspec(dllexport)
+#else
+#define DOODLE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DOODLE_ENV_LEFT 1
+#define DOODLE_ENV_RIGHT 2
+
+    typedef struct DoodleEnv DoodleEnv;
+
+    // threads = 0 uses every hardware thread; max_ticks = 0 lets games run until the player falls.
+    // Returns null if count is not positive.
+    DOODLE_ENV_API DoodleEnv *doodle_env_create(int count, uint64_t seed, int threads, int max_ticks);
+    DOODLE_ENV_API void doodle_env_destroy(DoodleEnv *env);
+
+    DOODLE_ENV_API int doodle_env_count(const DoodleEnv *env);
+    DOODLE_ENV_API int doodle_env_obs_size(void);
+
+    // Restart every game from seeds[count], or from the creation seed if seeds is null
+    DOODLE_ENV_API void doodle_env_reset(DoodleEnv *env, const uint64_t *seeds, float *observations);
+
+    // Restart one game; observation (doodle_env_obs_size() floats) may be null
+    DOODLE_ENV_API void doodle_env_reset_one(DoodleEnv *env, int index, uint64_t seed, float *observation);
+
+    DOODLE_ENV_API void doodle_env_step(DoodleEnv *env, const uint8_t *actions, float *observations, float *rewards, uint8_t *dones);
+
+    // Final score of the last game that ended at an index
+    DOODLE_ENV_API int doodle_env_episode_score(const DoodleEnv *env, int index);
+
+#ifdef __cplusplus
+}
+#endif
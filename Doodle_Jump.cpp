@@ -1,589 +1,538 @@
 ﻿#include <SFML/Graphics.hpp>
+#include "GameSim.h"
+#include "FramePacer.h"
+#include "GameScreens.h"
+#include "AssetArchive.h"
+#include "FrameProfiler.h"
+#include "SimThread.h"
+#include "ScoreStore.h"
+#include "FrameCapture.h"
+#include "ScoreClient.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <ctime>
 #include <sstream>
 #include <cmath>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <random>
 using namespace sf;
 
-// Game constants
-const int WINDOW_WIDTH = 400;
-const int WINDOW_HEIGHT = 533;
-const int PLATFORM_COUNT = 10;
-const int PLATFORM_SPACING = 60;
-const int MIN_PLATFORMS = 4;
-const int PLAYER_WIDTH = 50;
-const int PLAYER_HEIGHT = 70;
-const int PLATFORM_WIDTH = 68;
-const int PLATFORM_HEIGHT = 14;
-const float GRAVITY = 0.2f;
-const float JUMP_POWER = 11.0f;
-const int PLAYER_SPEED = 4;
-const int SCREEN_BOUNDARY_RIGHT = 350;
-const int SCREEN_BOUNDARY_LEFT = 0;
-const int CAMERA_THRESHOLD = 200;
-const int SCORE_INCREMENT = 1;
-const int DIFFICULTY_SCORE_THRESHOLD = 100;
-const Color HOVER_COLOR = Color(255, 200, 87);
-const Color TEXT_COLOR = Color::White;
-const Color SECONDARY_TEXT_COLOR = Color(200, 220, 255);
-const Color ACCENT_COLOR = Color(0, 255, 150);
-const Color BUTTON_BG_COLOR = Color(40, 50, 80);
-
-const int BUTTON_WIDTH = 120;
-const int BUTTON_HEIGHT = 50;
-const int BUTTON_SPACING = 20;
-const int PADDING = 20;
-
-struct point
+// Movement keys as GameInput bits; 0 for any other key
+std::uint8_t movementMask(Keyboard::Key code)
 {
-    int x, y;
-};
+    if (code == Keyboard::Key::Left)
+        return INPUT_LEFT;
+    if (code == Keyboard::Key::Right)
+        return INPUT_RIGHT;
+    return 0;
+}
 
-int loadHighScore()
+// Summary of --latency-test samples, in milliseconds
+void printLatencyReport(std::vector<double> samples)
 {
-    int highScore = 0;
-    std::ifstream file("highscore.txt");
-    if (file.is_open())
+    if (samples.empty())
     {
-        file >> highScore;
-        file.close();
+        std::cout << "Latency test: no movement key presses were measured\n";
+        return;
     }
-    return highScore;
+    std::sort(samples.begin(), samples.end());
+    double total = 0;
+    for (double sample : samples)
+        total += sample;
+    std::cout << "Input-to-present latency over " << samples.size() << " presses: mean " << total / samples.size()
+              << " ms, p50 " << samples[samples.size() / 2] << " ms, p95 " << samples[samples.size() * 95 / 100]
+              << " ms, max " << samples.back() << " ms\n";
 }
 
-void saveHighScore(int score)
-{
-    std::ofstream file("highscore.txt");
-    file << score;
-    file.close();
-}
+// Rows of the leaderboard shown on the menu
+const int MENU_LEADERBOARD_ROWS = 5;
 
-void drawStyledButton(RenderWindow &app, const std::string &label, const Font &font,
-                      const Vector2f &position, const Vector2f &size,
-                      bool isHovered, int fontSize)
+std::string leaderboardText(const std::vector<ScoreRecord> &top)
 {
-    RectangleShape buttonBg(size);
-    buttonBg.setPosition(position);
-    buttonBg.setFillColor(isHovered ? Color(60, 70, 100) : Color(30, 40, 70));
-    buttonBg.setOutlineThickness(2.0f);
-    buttonBg.setOutlineColor(isHovered ? HOVER_COLOR : Color(100, 120, 150));
-    app.draw(buttonBg);
-
-    Text buttonText(font);
-    buttonText.setString(label);
-    buttonText.setCharacterSize(fontSize);
-    buttonText.setFillColor(isHovered ? HOVER_COLOR : TEXT_COLOR);
-
-    FloatRect textBounds = buttonText.getLocalBounds();
-    float textX = position.x + (size.x - textBounds.size.x) / 2 - textBounds.position.x;
-    float textY = position.y + (size.y - textBounds.size.y) / 2 - textBounds.position.y;
-    buttonText.setPosition(Vector2f(textX, textY));
-    app.draw(buttonText);
+    std::ostringstream text;
+    for (int i = 0; i < MENU_LEADERBOARD_ROWS && i < (int)top.size(); i++)
+    {
+        text << i + 1 << ".  " << top[i].score << "\n";
+    }
+    return top.empty() ? "No runs yet" : text.str();
 }
 
-int main()
+int main(int argc, char **argv)
 {
-    srand((unsigned int)time(0));
+    // Command line: --uncapped, --low-latency and --fps=N control frame pacing, --no-replay disables recording,
+    // --profile-out=FILE writes per-frame phase timings (.csv or .json) on exit,
+    // --latency-test measures input-to-present latency of movement keys,
+    // --capture=PATH records every presented frame (.y4m video, otherwise a directory of PNGs)
+    // and --capture-workers=N sets the PNG encoder threads,
+    // --score-server=HOST[:PORT] submits normal runs to a shared leaderboard shown on the menu
+    PacingMode pacingMode = PacingMode::Capped;
+    double targetFps = 60.0;
+    bool recordReplays = true;
+    bool latencyTest = false;
+    std::string profileOutput;
+    std::string capturePath;
+    int captureWorkers = 2;
+    std::string scoreServer;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--no-replay") == 0)
+            recordReplays = false;
+        else if (std::strcmp(argv[i], "--uncapped") == 0)
+            pacingMode = PacingMode::Uncapped;
+        else if (std::strcmp(argv[i], "--low-latency") == 0)
+            pacingMode = PacingMode::LatencyTarget;
+        else if (std::strncmp(argv[i], "--fps=", 6) == 0)
+            targetFps = std::max(1.0, std::atof(argv[i] + 6));
+        else if (std::strncmp(argv[i], "--profile-out=", 14) == 0)
+            profileOutput = argv[i] + 14;
+        else if (std::strcmp(argv[i], "--latency-test") == 0)
+            latencyTest = true;
+        else if (std::strncmp(argv[i], "--capture=", 10) == 0)
+            capturePath = argv[i] + 10;
+        else if (std::strncmp(argv[i], "--capture-workers=", 18) == 0)
+            captureWorkers = std::max(1, std::atoi(argv[i] + 18));
+        else if (std::strncmp(argv[i], "--score-server=", 15) == 0)
+            scoreServer = argv[i] + 15;
+    }
+
+    // A recording plays back at a fixed rate, so capture locks frames to the tick rate
+    if (!capturePath.empty())
+    {
+        pacingMode = PacingMode::Capped;
+        targetFps = TICK_RATE;
+    }
+
+    // Assets come from the packed archive; a development tree without one falls back to the loose files
+    AssetArchive archive;
+    std::string assetError;
+    if (!archive.open(ASSET_ARCHIVE_PATH, assetError))
+    {
+        std::cerr << "Asset archive unavailable (" << assetError << "), loading loose files\n";
+        if (!archive.openLoose(std::vector<std::string>(std::begin(GAME_ASSET_FILES), std::end(GAME_ASSET_FILES)), assetError))
+        {
+            std::cerr << "Failed to load game assets: " << assetError << "\n";
+            return 1;
+        }
+    }
+
+    // Image decoding is the slow part of startup, so it runs while the window and menu come up
+    TextureAtlas atlas;
+    std::string atlasError;
+    std::future<bool> atlasReady = std::async(std::launch::async, [&]()
+                                              { return decodeAtlas(archive, atlas, atlasError); });
+    bool assetsLoaded = false;
 
-    RenderWindow app(VideoMode(Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)), "Doodle Jump");
-    app.setFramerateLimit(60);
+    // Frames of a fixed size are captured, so the window cannot be resized while recording
+    RenderWindow app(VideoMode(Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)), "Doodle Jump",
+                     capturePath.empty() ? Style::Default : Style::Titlebar | Style::Close);
     app.setTitle("Doodle Jump - Jump High!");
+    app.setKeyRepeatEnabled(false);
 
-    Texture t1, t2, t3, resumeTex;
-    t1.loadFromFile("images/background.png");
-    t2.loadFromFile("images/platform.png");
-    t3.loadFromFile("images/doodle.png");
-    resumeTex.loadFromFile("images/resume.png");
+    FrameCapture capture;
+    if (!capturePath.empty())
+    {
+        bool video = capturePath.size() >= 4 && capturePath.compare(capturePath.size() - 4, 4, ".y4m") == 0;
+        std::string captureError;
+        if (!capture.open(capturePath, video ? CaptureFormat::Y4M : CaptureFormat::PNG, Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT),
+                          TICK_RATE, captureWorkers, captureError))
+        {
+            std::cerr << "Failed to start capture: " << captureError << "\n";
+            return 1;
+        }
+    }
 
+    // The font reads glyphs from the archive bytes on demand, which stay mapped until exit
     Font font;
-    font.openFromFile("images/font.otf");
-
-    Sprite sBackground(t1), sPlat(t2), sPers(t3);
-    Sprite resumeButton(resumeTex);
-
-    float playButtonWidth = resumeButton.getGlobalBounds().size.x;
-    resumeButton.setPosition(Vector2f(WINDOW_WIDTH / 2 - playButtonWidth / 2, 200));
-
-    Text titleText(font);
-    titleText.setCharacterSize(52);
-    titleText.setFillColor(ACCENT_COLOR);
-    titleText.setString("DOODLE JUMP");
-
-    Text subtitleText(font);
-    subtitleText.setCharacterSize(16);
-    subtitleText.setFillColor(SECONDARY_TEXT_COLOR);
-    subtitleText.setString("Jump to the top!");
-
-    Text instructionsText(font);
-    instructionsText.setCharacterSize(14);
-    instructionsText.setFillColor(ACCENT_COLOR);
-    instructionsText.setString("Controls:");
-
-    Text controlsText(font);
-    controlsText.setCharacterSize(12);
-    controlsText.setFillColor(SECONDARY_TEXT_COLOR);
-    controlsText.setString("LEFT/RIGHT Arrow Keys\nSPACE to Pause");
-
-    Text hsLabelText(font);
-    hsLabelText.setCharacterSize(14);
-    hsLabelText.setFillColor(ACCENT_COLOR);
-    hsLabelText.setString("Best Score");
-
-    Text hsText(font);
-    hsText.setCharacterSize(32);
-    hsText.setFillColor(HOVER_COLOR);
-
-    Text scoreTextShadow(font);
-    scoreTextShadow.setCharacterSize(24);
-    scoreTextShadow.setFillColor(Color(0, 0, 0, 150));
-
-    Text scoreText(font);
-    scoreText.setCharacterSize(24);
-    scoreText.setFillColor(ACCENT_COLOR);
-
-    Text scoreLabelText(font);
-    scoreLabelText.setCharacterSize(12);
-    scoreLabelText.setFillColor(SECONDARY_TEXT_COLOR);
-    scoreLabelText.setString("SCORE");
-
-    Text pausedText(font);
-    pausedText.setCharacterSize(50);
-    pausedText.setFillColor(HOVER_COLOR);
-    pausedText.setString("PAUSED");
-
-    Text resumeLabel(font);
-    resumeLabel.setCharacterSize(12);
-    resumeLabel.setFillColor(SECONDARY_TEXT_COLOR);
-    resumeLabel.setString("Click to Resume");
-
-    Text gameOverText(font);
-    gameOverText.setCharacterSize(50);
-    gameOverText.setFillColor(Color(255, 100, 100));
-    gameOverText.setString("GAME OVER");
-
-    Text scoreLabel(font);
-    scoreLabel.setCharacterSize(16);
-    scoreLabel.setFillColor(SECONDARY_TEXT_COLOR);
-    scoreLabel.setString("Your Score");
-
-    Text finalScoreText(font);
-    finalScoreText.setCharacterSize(48);
-    finalScoreText.setFillColor(HOVER_COLOR);
-
-    Text separator1(font);
-    separator1.setCharacterSize(14);
-    separator1.setFillColor(SECONDARY_TEXT_COLOR);
-    separator1.setString("_____________________________________________________________________");
-
-    Text highScoreLabel(font);
-    highScoreLabel.setCharacterSize(16);
-    highScoreLabel.setFillColor(SECONDARY_TEXT_COLOR);
-    highScoreLabel.setString("Best Score");
-
-    Text highScoreText(font);
-    highScoreText.setCharacterSize(36);
-    highScoreText.setFillColor(ACCENT_COLOR);
-
-    RectangleShape overlay(Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
-    overlay.setFillColor(Color(0, 0, 0, 180));
-
-    RectangleShape pauseOverlay(Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
-    pauseOverlay.setFillColor(Color(0, 0, 0, 200));
-
-    enum GameState
+    std::size_t fontSize = 0;
+    const std::uint8_t *fontData = archive.find(ASSET_FONT, fontSize);
+    if (!fontData || !font.openFromMemory(fontData, fontSize))
     {
-        MENU,
-        PLAYING,
-        PAUSED,
-        GAME_OVER
-    };
+        std::cerr << "Failed to load game assets: cannot open font " << ASSET_FONT << "\n";
+        return 1;
+    }
+
+    GameScreens screens(font, atlas);
     GameState state = MENU;
 
     Vector2f mousePos(0, 0);
 
-    // Button bounds used for hit detection across different game states
-    FloatRect playButtonBounds;
-    FloatRect pauseExitButtonBounds;
-    FloatRect gameOverPlayAgainButtonBounds;
-    FloatRect gameOverExitButtonBounds;
-
-    int currentScore = 0;
-    int highScore = loadHighScore();
-    int maxHeight = WINDOW_HEIGHT;
-    int minPlayerY = WINDOW_HEIGHT;
-    int activePlatforms = PLATFORM_COUNT;
-    int lastDifficultyLevel = 0;
-    int lastPlatformY = WINDOW_HEIGHT - 80;
-
-    point plat[PLATFORM_COUNT];
-    bool platScored[PLATFORM_COUNT];
-    int x = WINDOW_WIDTH / 2, y = WINDOW_HEIGHT - 145, h = CAMERA_THRESHOLD;
-    float dx = 0, dy = 0;
-    int frameCounter = 0;
-
-    auto initializePlatforms = [&]()
+    // Scores are kept in memory and written to disk on a background thread
+    ScoreStore scores;
+    scores.open();
+    int leaderboardVersion = -1;
+
+    // With a score server, finished runs are sent to it in the background and the menu
+    // shows its shared leaderboard instead of this station's
+    std::unique_ptr<ScoreClient> scoreClient;
+    std::vector<ScoreRecord> sharedLeaderboard;
+    bool haveSharedLeaderboard = false;
+    if (!scoreServer.empty())
+    {
+        size_t colon = scoreServer.rfind(':');
+        int port = colon == std::string::npos ? SCORE_SERVER_PORT : std::atoi(scoreServer.c_str() + colon + 1);
+        scoreClient = std::make_unique<ScoreClient>(scoreServer.substr(0, colon), port);
+    }
+
+    // The game ticks on its own thread; this thread only reads its latest snapshot.
+    // Every run is recorded as seed + inputs and written to replays/ by the score store's
+    // writer thread, so it can be reproduced or verified later.
+    SimThread::ReplaySink saveReplay;
+    if (recordReplays)
+        saveReplay = [&scores](const Replay &replay)
+        { scores.saveReplay(replay); };
+    SimThread simThread(saveReplay);
+    std::uint32_t currentRun = 0;
+    std::random_device seedSource;
+    GameMode mode = MODE_NORMAL;
+
+    auto startGame = [&]()
+    {
+        state = PLAYING;
+        std::uint64_t seed = ((std::uint64_t)seedSource() << 32) ^ (std::uint64_t)time(0);
+        currentRun = simThread.startRun(seed, mode);
+    };
+
+    // Window events are drained as soon as they arrive, including while the pacer waits.
+    // Movement keys go straight to the simulation's timestamped input queue; everything
+    // else is handled at the start of the next frame.
+    std::vector<Event> pendingEvents;
+    auto routeEvent = [&](const Event &event)
     {
-        // Difficulty increases as score grows - fewer platforms available
-        activePlatforms = PLATFORM_COUNT - (currentScore / DIFFICULTY_SCORE_THRESHOLD);
-        if (activePlatforms < MIN_PLATFORMS)
+        InputQueue::Clock::time_point now = InputQueue::Clock::now();
+        const auto *pressed = event.getIf<Event::KeyPressed>();
+        const auto *released = event.getIf<Event::KeyReleased>();
+        if (pressed && movementMask(pressed->code))
         {
-            activePlatforms = MIN_PLATFORMS;
+            simThread.pushKey(now, movementMask(pressed->code), true);
         }
-
-        for (int i = 0; i < PLATFORM_COUNT; i++)
+        else if (released && movementMask(released->code))
         {
-            if (i < activePlatforms)
-            {
-                plat[i].x = rand() % (SCREEN_BOUNDARY_RIGHT - PLATFORM_WIDTH);
-                plat[i].y = i * PLATFORM_SPACING;
-                platScored[i] = false;
-            }
-            else
-            {
-                // Disable unused platforms by placing off-screen
-                plat[i].y = -PLATFORM_HEIGHT * 2;
-                platScored[i] = false;
-            }
+            simThread.pushKey(now, movementMask(released->code), false);
         }
+        else
+        {
+            // Releases that happen while unfocused never arrive
+            if (event.is<Event::FocusLost>())
+                simThread.releaseKeys(now);
+            pendingEvents.push_back(event);
+        }
+    };
+    auto drainEvents = [&]()
+    {
+        while (const auto event = app.pollEvent())
+        {
+            routeEvent(*event);
+        }
+    };
 
-        // Always place starting platform at player spawn location
-        plat[activePlatforms - 1].x = WINDOW_WIDTH / 2 - PLATFORM_WIDTH / 2;
-        plat[activePlatforms - 1].y = WINDOW_HEIGHT - 80;
-
-        maxHeight = WINDOW_HEIGHT;
-        minPlayerY = WINDOW_HEIGHT;
-        frameCounter = 0;
-        lastPlatformY = WINDOW_HEIGHT - 80;
+    FramePacer pacer(pacingMode, targetFps);
+    pacer.setIdleCallback(drainEvents);
+
+    float alpha = 0;
+
+    // Latency test: a movement press is timed until the first frame that shows its tick has been
+    // presented. That frame also shows a white marker for measuring the display with a camera.
+    bool latencyPending = false;
+    std::uint32_t measuredPresses = 0;
+    InputQueue::Clock::time_point latencyPressTime;
+    std::vector<double> latencySamples;
+    RectangleShape latencyMarker(Vector2f(24, 24));
+    latencyMarker.setPosition(Vector2f(WINDOW_WIDTH - 34, 10));
+
+    // Frame phase timings, shown by F3 and refreshed twice a second so the text stays readable
+    FrameProfiler profiler;
+    bool showProfiler = false;
+    int profilerRefreshFrames = 0;
+    RectangleShape profilerBackground(Vector2f(WINDOW_WIDTH - 2 * PADDING, 150));
+    profilerBackground.setPosition(Vector2f(PADDING, WINDOW_HEIGHT - 170));
+    profilerBackground.setFillColor(Color(0, 0, 0, 170));
+    Label profilerText(font, "", 12, TEXT_COLOR);
+    profilerText.setPosition(Vector2f(PADDING + 8, WINDOW_HEIGHT - 164));
+
+    // Menu, pause and game over screens only change on input. While one is up the loop
+    // sleeps in waitEvent, draws from the screen cache and presents only when an event
+    // changed something, so an idle game uses next to no CPU or GPU. A capture records
+    // every frame, so nothing is idle while one runs. Effects hold still while paused,
+    // so only the other screens wait for them to finish.
+    bool idleRedraw = true;
+    GameState drawnState = state;
+    auto isIdle = [&]()
+    {
+        return state != PLAYING && assetsLoaded && !showProfiler && (state == PAUSED || !screens.effectsActive()) &&
+               !capture.isOpen();
     };
 
-    initializePlatforms();
+    // Effects advance by real frame time, capped so a long idle wait does not jump them ahead
+    InputQueue::Clock::time_point lastEffectsTime = InputQueue::Clock::now();
 
     while (app.isOpen())
     {
-        frameCounter++;
+        if (isIdle() && !idleRedraw)
+        {
+            // A shared leaderboard can change without any event, so it is polled once a second
+            if (const auto event = app.waitEvent(scoreClient ? seconds(1) : Time::Zero))
+                routeEvent(*event);
+        }
 
-        if (const auto event = app.pollEvent())
+        profiler.beginFrame();
         {
-            if (event->is<Event::Closed>())
-                app.close();
+            ProfileScope scope(profiler, PHASE_WAIT);
+            if (!isIdle())
+                pacer.frameStart();
+        }
 
-            if (event->is<Event::KeyPressed>())
+        if (!assetsLoaded && atlasReady.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            if (!atlasReady.get() || !atlas.upload())
             {
-                const auto *key = event->getIf<Event::KeyPressed>();
-                if (key && key->code == Keyboard::Key::Space)
-                {
-                    if (state == PLAYING)
-                    {
-                        state = PAUSED;
-                    }
-                    else if (state == PAUSED)
-                    {
-                        state = PLAYING;
-                    }
-                }
-                if (key && key->code == Keyboard::Key::Escape)
-                {
-                    if (state == GAME_OVER || state == PAUSED)
-                    {
-                        state = MENU;
-                    }
-                }
+                std::cerr << "Failed to load game assets: " << (atlasError.empty() ? "cannot create atlas texture" : atlasError) << "\n";
+                return 1;
             }
+            screens.atlasUploaded();
+            assetsLoaded = true;
+            idleRedraw = true;
+        }
 
-            if (event->is<Event::MouseMoved>())
+        {
+            ProfileScope scope(profiler, PHASE_EVENTS);
+            drainEvents();
+            for (const Event &event : pendingEvents)
             {
-                const auto *mouseMoved = event->getIf<Event::MouseMoved>();
-                if (mouseMoved)
-                {
-                    mousePos = app.mapPixelToCoords(mouseMoved->position);
-                }
-            }
+                if (event.is<Event::Closed>())
+                    app.close();
 
-            if (event->is<Event::MouseButtonPressed>())
-            {
-                const auto *mouse = event->getIf<Event::MouseButtonPressed>();
-                if (mouse)
-                {
-                    mousePos = app.mapPixelToCoords(mouse->position);
+                // Pointer moves only matter to a static screen if they change a button's hover
+                if (!event.is<Event::MouseMoved>())
+                    idleRedraw = true;
 
-                    if (state == MENU)
+                if (event.is<Event::KeyPressed>())
+                {
+                    const auto *key = event.getIf<Event::KeyPressed>();
+                    if (key && key->code == Keyboard::Key::Space)
                     {
-                        if (playButtonBounds.contains(mousePos))
+                        if (state == PLAYING)
                         {
-                            state = PLAYING;
-                            currentScore = 0;
-                            initializePlatforms();
-                            x = WINDOW_WIDTH / 2;
-                            y = WINDOW_HEIGHT - 145;
-                            dx = 0;
-                            dy = 0;
+                            state = PAUSED;
+                            simThread.setPaused(true);
                         }
-                    }
-
-                    if (state == PAUSED)
-                    {
-                        FloatRect resumeButtonBounds = resumeButton.getGlobalBounds();
-                        if (resumeButtonBounds.contains(mousePos))
+                        else if (state == PAUSED)
                         {
                             state = PLAYING;
+                            simThread.setPaused(false);
                         }
                     }
-
-                    if (state == PAUSED)
+                    if (key && key->code == Keyboard::Key::F3)
                     {
-                        if (pauseExitButtonBounds.contains(mousePos))
-                        {
-                            app.close();
-                        }
+                        showProfiler = !showProfiler;
+                        profilerRefreshFrames = 0;
                     }
-
-                    if (state == GAME_OVER)
+                    if (key && key->code == Keyboard::Key::Escape)
                     {
-                        if (gameOverPlayAgainButtonBounds.contains(mousePos))
+                        if (state == GAME_OVER || state == PAUSED)
                         {
-                            state = PLAYING;
-                            currentScore = 0;
-                            initializePlatforms();
-                            x = WINDOW_WIDTH / 2;
-                            y = WINDOW_HEIGHT - 145;
-                            dx = 0;
-                            dy = 0;
+                            simThread.abandonRun();
+                            state = MENU;
                         }
                     }
+                }
 
-                    if (state == GAME_OVER)
+                if (event.is<Event::MouseMoved>())
+                {
+                    const auto *mouseMoved = event.getIf<Event::MouseMoved>();
+                    if (mouseMoved)
                     {
-                        if (gameOverExitButtonBounds.contains(mousePos))
-                        {
-                            app.close();
-                        }
+                        mousePos = app.mapPixelToCoords(mouseMoved->position);
                     }
                 }
-            }
-        }
-
-        if (state == PLAYING)
-        {
-            if (Keyboard::isKeyPressed(Keyboard::Key::Right))
-            {
-                x += PLAYER_SPEED;
-            }
-            if (Keyboard::isKeyPressed(Keyboard::Key::Left))
-            {
-                x -= PLAYER_SPEED;
-            }
-
-            // Wrap player position within horizontal bounds
-            if (x < SCREEN_BOUNDARY_LEFT)
-                x = SCREEN_BOUNDARY_LEFT;
-            if (x > SCREEN_BOUNDARY_RIGHT)
-                x = SCREEN_BOUNDARY_RIGHT;
-
-            dy += GRAVITY;
-            y += (int)dy;
 
-            // Check collision with each platform
-            for (int i = 0; i < activePlatforms; i++)
-            {
-                if ((x + PLAYER_WIDTH / 2 > plat[i].x) &&
-                    (x + PLAYER_WIDTH / 2 < plat[i].x + PLATFORM_WIDTH) && (y + PLAYER_HEIGHT > plat[i].y) &&
-                    (y + PLAYER_HEIGHT < plat[i].y + PLATFORM_HEIGHT) &&
-                    (dy > 0))
+                if (event.is<Event::MouseButtonPressed>())
                 {
-                    dy = -JUMP_POWER;
-
-                    // Only award points once per platform touch
-                    if (!platScored[i])
+                    const auto *mouse = event.getIf<Event::MouseButtonPressed>();
+                    if (mouse)
                     {
-                        // Longer jumps are rewarded with more points
-                        int jumpDistance = lastPlatformY - plat[i].y;
+                        mousePos = app.mapPixelToCoords(mouse->position);
 
-                        if (jumpDistance >= 80)
+                        ScreenButton button = screens.buttonAt(state, mousePos);
+                        if (button == BUTTON_PLAY || button == BUTTON_PLAY_AGAIN)
                         {
-                            currentScore += 2;
+                            startGame();
                         }
-                        else
+                        else if (button == BUTTON_MODE)
                         {
-                            currentScore += 1;
+                            mode = (GameMode)((mode + 1) % MODE_COUNT);
+                            screens.setMode(mode);
                         }
-
-                        lastPlatformY = plat[i].y;
-                        platScored[i] = true;
-
-                        // Adjust difficulty: reduce available platforms as score increases
-                        int currentDifficultyLevel = currentScore / DIFFICULTY_SCORE_THRESHOLD;
-                        int newActivePlatforms = PLATFORM_COUNT - currentDifficultyLevel;
-                        if (newActivePlatforms < MIN_PLATFORMS)
+                        else if (button == BUTTON_RESUME)
                         {
-                            newActivePlatforms = MIN_PLATFORMS;
+                            state = PLAYING;
+                            simThread.setPaused(false);
+                        }
+                        else if (button == BUTTON_EXIT)
+                        {
+                            app.close();
                         }
-
-                        activePlatforms = newActivePlatforms;
                     }
                 }
             }
+            pendingEvents.clear();
+        }
+
+        // Snapshots from before the current game started are ignored
+        const SimSnapshot &snapshot = simThread.latest();
+        bool snapshotCurrent = snapshot.run == currentRun;
+        if (state == PLAYING && snapshotCurrent)
+        {
+            // Draw between the previous and current tick so motion stays smooth at any refresh rate
+            float sinceTick = std::chrono::duration<float>(InputQueue::Clock::now() - snapshot.time).count();
+            alpha = std::clamp(sinceTick / (float)TICK_SECONDS, 0.0f, 1.0f);
 
             // End game when player falls off screen
-            if (y > WINDOW_HEIGHT)
+            if (snapshot.gameOver)
             {
                 state = GAME_OVER;
-                if (currentScore > highScore)
-                {
-                    highScore = currentScore;
-                    saveHighScore(highScore);
-                }
-            }
-
-            // Camera follows player upward - scroll platforms down relative to camera
-            if (y < h)
-            {
-                for (int i = 0; i < activePlatforms; i++)
-                {
-                    y = h;
-                    plat[i].y = plat[i].y - (int)dy;
-
-                    // Recycle platform when it scrolls off bottom
-                    if (plat[i].y > WINDOW_HEIGHT)
-                    {
-                        plat[i].y = -PLATFORM_HEIGHT;
-                        platScored[i] = false;
-
-                        // Find highest platform to maintain consistent spacing
-                        int maxPlatformY = 0;
-                        for (int j = 0; j < activePlatforms; j++)
-                        {
-                            if (plat[j].y < 0)
-                                maxPlatformY = std::min(maxPlatformY, plat[j].y);
-                        }
 
-                        // Spawn new platform at top
-                        plat[i].y = maxPlatformY - PLATFORM_SPACING;
-                        plat[i].x = rand() % (SCREEN_BOUNDARY_RIGHT - PLATFORM_WIDTH);
-                    }
-                }
+                // Other modes score differently, so only normal runs are ranked
+                ScoreRecord record;
+                record.timestamp = (std::int64_t)time(0);
+                record.score = snapshot.score;
+                record.height = snapshot.heightClimbed;
+                record.durationMs = (int)(snapshot.ticks * TICK_SECONDS * 1000);
+                screens.setRank(mode == MODE_NORMAL ? scores.submit(record) : 0);
+
+                // The server re-simulates the run's inputs before ranking it
+                Replay run;
+                if (scoreClient && mode == MODE_NORMAL && simThread.takeFinishedRun(currentRun, run))
+                    scoreClient->submit(std::move(run));
             }
         }
-
-        app.clear(Color(20, 20, 40));
-        app.draw(sBackground);
-
-        if (state == MENU)
+        if (latencyTest && snapshotCurrent && snapshot.pressCount != measuredPresses)
         {
-            float titleX = (WINDOW_WIDTH - titleText.getGlobalBounds().size.x) / 2;
-            titleText.setPosition(Vector2f(titleX, 40));
-            app.draw(titleText);
-
-            float subtitleX = (WINDOW_WIDTH - subtitleText.getGlobalBounds().size.x) / 2;
-            subtitleText.setPosition(Vector2f(subtitleX, 110));
-            app.draw(subtitleText);
-
-            float playButtonX = (WINDOW_WIDTH - BUTTON_WIDTH) / 2;
-            float playButtonY = 170;
-            playButtonBounds = FloatRect(Vector2f(playButtonX, playButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-            bool playHovered = playButtonBounds.contains(mousePos);
-            drawStyledButton(app, "PLAY", font, Vector2f(playButtonX, playButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT), playHovered, 36);
-
-            instructionsText.setPosition(Vector2f(PADDING, 280));
-            app.draw(instructionsText);
-
-            controlsText.setPosition(Vector2f(PADDING, 310));
-            app.draw(controlsText);
-
-            hsLabelText.setPosition(Vector2f(PADDING, 450));
-            app.draw(hsLabelText);
+            measuredPresses = snapshot.pressCount;
+            latencyPending = true;
+            latencyPressTime = snapshot.lastPressTime;
+        }
 
-            hsText.setString(std::to_string(highScore));
-            hsText.setPosition(Vector2f(PADDING, 470));
-            app.draw(hsText);
+        if (scoreClient && scoreClient->takeLeaderboard(sharedLeaderboard))
+        {
+            haveSharedLeaderboard = true;
+            leaderboardVersion = -1;
         }
-        else if (state == PLAYING || state == PAUSED)
+        if (state == MENU && leaderboardVersion != scores.version())
+        {
+            screens.setLeaderboard(leaderboardText(haveSharedLeaderboard ? sharedLeaderboard : scores.top()));
+            leaderboardVersion = scores.version();
+            idleRedraw = true;
+        }
+
+        ScreenView view;
+        view.state = state;
+        view.snapshot = snapshotCurrent ? &snapshot : nullptr;
+        view.alpha = alpha;
+        view.mousePos = mousePos;
+        view.bestScore = scores.best();
+
+        InputQueue::Clock::time_point frameTime = InputQueue::Clock::now();
+        float effectsSeconds = std::min(std::chrono::duration<float>(frameTime - lastEffectsTime).count(), 0.1f);
+        lastEffectsTime = frameTime;
+        screens.updateEffects(view, effectsSeconds);
+
+        // A static screen that looks the same as last time is not presented again
+        bool idle = isIdle();
+        if (idle)
         {
-            for (int i = 0; i < activePlatforms; i++)
+            if (state != drawnState || screens.updateHover(view))
+                idleRedraw = true;
+            if (!idleRedraw)
             {
-                sPlat.setPosition(Vector2f(plat[i].x, plat[i].y));
-                app.draw(sPlat);
+                profiler.discardFrame();
+                continue;
             }
+        }
 
-            sPers.setPosition(Vector2f(x, y));
-            app.draw(sPers);
-
-            scoreTextShadow.setPosition(Vector2f(13, 13));
-            scoreTextShadow.setString(std::to_string(currentScore));
-            app.draw(scoreTextShadow);
-
-            scoreText.setPosition(Vector2f(10, 10));
-            scoreText.setString(std::to_string(currentScore));
-            app.draw(scoreText);
-
-            scoreLabelText.setPosition(Vector2f(10, 40));
-            app.draw(scoreLabelText);
+        {
+            ProfileScope scope(profiler, PHASE_DRAW);
+            if (idle)
+                screens.drawCached(app, view);
+            else
+                screens.draw(app, view);
 
-            if (state == PAUSED)
+            // Phase timing overlay, toggled with F3
+            if (showProfiler)
             {
-                app.draw(overlay);
-
-                float pausedX = (WINDOW_WIDTH - pausedText.getGlobalBounds().size.x) / 2;
-                pausedText.setPosition(Vector2f(pausedX, 80));
-                app.draw(pausedText);
-
-                app.draw(resumeButton);
-
-                float resumeLabelX = (WINDOW_WIDTH - resumeLabel.getGlobalBounds().size.x) / 2;
-                resumeLabel.setPosition(Vector2f(resumeLabelX, 280));
-                app.draw(resumeLabel);
+                if (profilerRefreshFrames-- <= 0)
+                {
+                    std::ostringstream lines;
+                    lines.setf(std::ios::fixed);
+                    lines.precision(2);
+                    lines << "ms        p50    p95    p99\n";
+                    for (int phase = 0; phase <= PHASE_COUNT; phase++)
+                    {
+                        PhasePercentiles p = profiler.percentiles(phase);
+                        std::string name = phase < PHASE_COUNT ? PROFILE_PHASE_NAMES[phase] : "frame";
+                        name.resize(8, ' ');
+                        lines << name << "  " << p.p50 << "  " << p.p95 << "  " << p.p99 << "\n";
+                    }
+                    profilerText.setString(lines.str());
+                    profilerRefreshFrames = 30;
+                }
+                app.draw(profilerBackground);
+                profilerText.draw(app);
+            }
 
-                float exitButtonX = (WINDOW_WIDTH - BUTTON_WIDTH) / 2;
-                float exitButtonY = 330;
-                pauseExitButtonBounds = FloatRect(Vector2f(exitButtonX, exitButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-                bool exitHovered = pauseExitButtonBounds.contains(mousePos);
-                drawStyledButton(app, "EXIT", font, Vector2f(exitButtonX, exitButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT), exitHovered, 32);
+            if (latencyPending)
+            {
+                app.draw(latencyMarker);
             }
         }
-        else if (state == GAME_OVER)
+
+        {
+            ProfileScope scope(profiler, PHASE_DISPLAY);
+            capture.captureWindow(app);
+            app.display();
+        }
+        idleRedraw = false;
+        drawnState = state;
+        if (latencyPending)
+        {
+            latencySamples.push_back(std::chrono::duration<double, std::milli>(InputQueue::Clock::now() - latencyPressTime).count());
+            latencyPending = false;
+        }
         {
-            app.draw(pauseOverlay);
-
-            float gameOverX = (WINDOW_WIDTH - gameOverText.getGlobalBounds().size.x) / 2;
-            gameOverText.setPosition(Vector2f(gameOverX, 50));
-            app.draw(gameOverText);
-
-            float scoreLabelX = (WINDOW_WIDTH - scoreLabel.getGlobalBounds().size.x) / 2;
-            scoreLabel.setPosition(Vector2f(scoreLabelX, 130));
-            app.draw(scoreLabel);
-
-            finalScoreText.setString(std::to_string(currentScore));
-            float scoreX = (WINDOW_WIDTH - finalScoreText.getGlobalBounds().size.x) / 2;
-            finalScoreText.setPosition(Vector2f(scoreX, 160));
-            app.draw(finalScoreText);
-
-            float sep1X = (WINDOW_WIDTH - separator1.getGlobalBounds().size.x) / 2;
-            separator1.setPosition(Vector2f(sep1X, 225));
-            app.draw(separator1);
-
-            float hsLabelX = (WINDOW_WIDTH - highScoreLabel.getGlobalBounds().size.x) / 2;
-            highScoreLabel.setPosition(Vector2f(hsLabelX, 250));
-            app.draw(highScoreLabel);
-
-            highScoreText.setString(std::to_string(highScore));
-            float hsX = (WINDOW_WIDTH - highScoreText.getGlobalBounds().size.x) / 2;
-            highScoreText.setPosition(Vector2f(hsX, 275));
-            app.draw(highScoreText);
-
-            float playAgainButtonX = (WINDOW_WIDTH - BUTTON_WIDTH) / 2;
-            float playAgainButtonY = 350;
-            gameOverPlayAgainButtonBounds = FloatRect(Vector2f(playAgainButtonX, playAgainButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-            bool playAgainHovered = gameOverPlayAgainButtonBounds.contains(mousePos);
-            drawStyledButton(app, "PLAY AGAIN", font, Vector2f(playAgainButtonX, playAgainButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT), playAgainHovered, 22);
-
-            float exitButtonX = (WINDOW_WIDTH - BUTTON_WIDTH) / 2;
-            float exitButtonY = 410;
-            gameOverExitButtonBounds = FloatRect(Vector2f(exitButtonX, exitButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-            bool exitHovered = gameOverExitButtonBounds.contains(mousePos);
-            drawStyledButton(app, "EXIT", font, Vector2f(exitButtonX, exitButtonY), Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT), exitHovered, 32);
+            ProfileScope scope(profiler, PHASE_WAIT);
+            pacer.frameEnd();
         }
 
-        app.display();
+        // The simulation runs alongside on its own thread; its phases are added as they accrue
+        profiler.add(PHASE_INPUT, simThread.takePhaseTime(PHASE_INPUT));
+        profiler.add(PHASE_PHYSICS, simThread.takePhaseTime(PHASE_PHYSICS));
+        profiler.add(PHASE_RECYCLE, simThread.takePhaseTime(PHASE_RECYCLE));
+        profiler.endFrame();
+    }
+
+    if (latencyTest)
+    {
+        printLatencyReport(latencySamples);
+    }
+
+    if (capture.isOpen())
+    {
+        bool written = capture.close();
+        std::cout << "Captured " << capture.captured() << " frames to " << capturePath << ", " << capture.dropped()
+                  << " dropped\n";
+        if (!written)
+            std::cerr << "Capture incomplete: " << capture.writeError() << "\n";
+    }
+
+    if (!profileOutput.empty())
+    {
+        if (profiler.exportTimings(profileOutput))
+            std::cout << "Frame timings written to " << profileOutput << "\n";
+        else
+            std::cerr << "Could not write frame timings to " << profileOutput << "\n";
     }
 
     return 0;
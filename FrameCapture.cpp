@@ -0,0 +1,272 @@
+#include "FrameCapture.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace
+{
+    // Video frame in planar YUV 4:2:0, chroma planes at half size rounded up
+    struct YuvFrame
+    {
+        unsigned chromaWidth = 0, chromaHeight = 0;
+        std::vector<std::uint8_t> planes;
+    };
+
+    // BT.601 limited range, as players assume for untagged video
+    std::uint8_t lumaOf(int r, int g, int b)
+    {
+        return (std::uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+    }
+
+    // RGBA pixels to YUV, averaging each 2x2 block for its chroma sample
+    void convertToYuv(const sf::Image &image, YuvFrame &yuv)
+    {
+        sf::Vector2u size = image.getSize();
+        yuv.chromaWidth = (size.x + 1) / 2;
+        yuv.chromaHeight = (size.y + 1) / 2;
+        size_t lumaSize = (size_t)size.x * size.y;
+        size_t chromaSize = (size_t)yuv.chromaWidth * yuv.chromaHeight;
+        yuv.planes.resize(lumaSize + 2 * chromaSize);
+
+        const std::uint8_t *pixels = image.getPixelsPtr();
+        std::uint8_t *luma = yuv.planes.data();
+        std::uint8_t *cb = luma + lumaSize;
+        std::uint8_t *cr = cb + chromaSize;
+
+        for (size_t i = 0; i < lumaSize; i++)
+            luma[i] = lumaOf(pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2]);
+
+        for (unsigned cy = 0; cy < yuv.chromaHeight; cy++)
+        {
+            unsigned y0 = cy * 2, y1 = std::min(y0 + 1, size.y - 1);
+            for (unsigned cx = 0; cx < yuv.chromaWidth; cx++)
+            {
+                unsigned x0 = cx * 2, x1 = std::min(x0 + 1, size.x - 1);
+                const std::uint8_t *corners[4] = {
+                    pixels + ((size_t)y0 * size.x + x0) * 4, pixels + ((size_t)y0 * size.x + x1) * 4,
+                    pixels + ((size_t)y1 * size.x + x0) * 4, pixels + ((size_t)y1 * size.x + x1) * 4};
+                int r = 0, g = 0, b = 0;
+                for (const std::uint8_t *p : corners)
+                {
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+                r = (r + 2) / 4;
+                g = (g + 2) / 4;
+                b = (b + 2) / 4;
+
+                size_t i = (size_t)cy * yuv.chromaWidth + cx;
+                cb[i] = (std::uint8_t)(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+                cr[i] = (std::uint8_t)(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+            }
+        }
+    }
+
+    bool writeYuvFrame(std::FILE *file, const YuvFrame &yuv)
+    {
+        return std::fputs("FRAME\n", file) >= 0 &&
+               std::fwrite(yuv.planes.data(), 1, yuv.planes.size(), file) == yuv.planes.size();
+    }
+}
+
+FrameCapture::~FrameCapture()
+{
+    close();
+}
+
+bool FrameCapture::open(const std::string &capturePath, CaptureFormat captureFormat, sf::Vector2u frameSize,
+                        int fps, int workers, std::string &openError)
+{
+    close();
+    format = captureFormat;
+    size = frameSize;
+    path = capturePath;
+    nextFrame = 0;
+    closing = false;
+    error.clear();
+    framesWritten = 0;
+    framesDropped = 0;
+
+    for (int i = 0; i < CAPTURE_READBACK_DELAY; i++)
+    {
+        ringPending[i] = false;
+        if (!ring[i].resize(size))
+        {
+            openError = "cannot create capture texture";
+            return false;
+        }
+    }
+
+    if (format == CaptureFormat::Y4M)
+    {
+        video = std::fopen(path.c_str(), "wb");
+        if (!video)
+        {
+            openError = "cannot open " + path;
+            return false;
+        }
+        // 4:2:0 with chroma sited between the luma samples it was averaged from
+        std::fprintf(video, "YUV4MPEG2 W%u H%u F%d:1 Ip A1:1 C420jpeg\n", size.x, size.y, fps);
+        threads.emplace_back(&FrameCapture::writeVideo, this);
+    }
+    else
+    {
+        std::error_code created;
+        std::filesystem::create_directories(path, created);
+        if (created)
+        {
+            openError = "cannot create directory " + path;
+            return false;
+        }
+        for (int i = 0; i < std::max(workers, 1); i++)
+            threads.emplace_back(&FrameCapture::encodeImages, this);
+    }
+    return true;
+}
+
+void FrameCapture::captureWindow(const sf::Window &window)
+{
+    if (!isOpen())
+        return;
+
+    long long number = nextFrame++;
+    if (window.getSize() != size)
+    {
+        framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // The slot's previous copy was made CAPTURE_READBACK_DELAY frames ago and is
+    // ready to read without waiting; then the GPU copies this frame into it
+    int slot = (int)(number % CAPTURE_READBACK_DELAY);
+    if (ringPending[slot])
+        readBack(slot, false);
+    ring[slot].update(window);
+    ringFrame[slot] = number;
+    ringPending[slot] = true;
+}
+
+void FrameCapture::captureTexture(const sf::Texture &texture)
+{
+    if (!isOpen())
+        return;
+    enqueue({nextFrame++, texture.copyToImage()}, true);
+}
+
+void FrameCapture::readBack(int slot, bool wait)
+{
+    ringPending[slot] = false;
+    enqueue({ringFrame[slot], ring[slot].copyToImage()}, wait);
+}
+
+void FrameCapture::enqueue(Frame frame, bool wait)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (wait)
+        spaceFree.wait(lock, [&]()
+                       { return (int)queue.size() < CAPTURE_QUEUE_FRAMES; });
+    else if ((int)queue.size() >= CAPTURE_QUEUE_FRAMES)
+    {
+        framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    queue.push_back(std::move(frame));
+    lock.unlock();
+    frameReady.notify_one();
+}
+
+bool FrameCapture::popFrame(Frame &frame)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    frameReady.wait(lock, [&]()
+                    { return closing || !queue.empty(); });
+    if (queue.empty())
+        return false;
+
+    frame = std::move(queue.front());
+    queue.pop_front();
+    lock.unlock();
+    spaceFree.notify_one();
+    return true;
+}
+
+void FrameCapture::fail(const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error.empty())
+        error = message;
+}
+
+void FrameCapture::writeVideo()
+{
+    YuvFrame yuv;
+    long long expected = -1; // Number after the last frame written
+    bool failed = false;
+    Frame frame;
+    while (popFrame(frame))
+    {
+        // Frames keep being taken after a failure so a waiting producer is never stuck
+        if (failed)
+            continue;
+
+        // Frames arrive in order; a gap is frames that were dropped
+        if (expected >= 0)
+        {
+            for (; expected < frame.number && !failed; expected++)
+                failed = !writeYuvFrame(video, yuv);
+        }
+        convertToYuv(frame.image, yuv);
+        failed = failed || !writeYuvFrame(video, yuv);
+        expected = frame.number + 1;
+
+        if (failed)
+            fail("cannot write " + path);
+        else
+            framesWritten.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FrameCapture::encodeImages()
+{
+    Frame frame;
+    char name[32];
+    while (popFrame(frame))
+    {
+        std::snprintf(name, sizeof(name), "frame_%06lld.png", frame.number);
+        if (frame.image.saveToFile(std::filesystem::path(path) / name))
+            framesWritten.fetch_add(1, std::memory_order_relaxed);
+        else
+            fail("cannot write " + (std::filesystem::path(path) / name).string());
+    }
+}
+
+bool FrameCapture::close()
+{
+    if (!isOpen())
+        return true;
+
+    // The last few frames are still on the GPU; these are kept even if the queue is full
+    for (long long number = std::max(0LL, nextFrame - CAPTURE_READBACK_DELAY); number < nextFrame; number++)
+    {
+        int slot = (int)(number % CAPTURE_READBACK_DELAY);
+        if (ringPending[slot] && ringFrame[slot] == number)
+            readBack(slot, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    frameReady.notify_all();
+    for (std::thread &thread : threads)
+        thread.join();
+    threads.clear();
+
+    if (video)
+    {
+        if (std::fclose(video) != 0)
+            fail("cannot write " + path);
+        video = nullptr;
+    }
+    return error.empty();
+}
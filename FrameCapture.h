@@ -0,0 +1,98 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Frames read back from the GPU this many frames after they were copied, so the
+// copy has long finished and reading it does not stall on the frame being drawn
+const int CAPTURE_READBACK_DELAY = 3;
+
+// Frames waiting to be written at most; further window frames are dropped
+const int CAPTURE_QUEUE_FRAMES = 16;
+
+enum class CaptureFormat
+{
+    Y4M, // One uncompressed YUV 4:2:0 video file, written by a single thread
+    PNG  // Numbered images in a directory, encoded by a pool of threads
+};
+
+// Records rendered frames to disk without holding up the thread that renders them.
+//
+// Window frames are copied into a small ring of textures on the GPU and read
+// back a few frames later. Pixels then go through a bounded queue to writer
+// threads that convert, encode and write them. If the writers fall behind, a
+// window frame is dropped rather than waited for, and counted. A Y4M stream
+// repeats the previous frame in a dropped frame's place so the video keeps
+// its timing; a PNG sequence skips that frame number.
+class FrameCapture
+{
+public:
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    // Start capturing frames of the given size. Y4M writes the file at path, tagged with fps;
+    // PNG writes frame_000000.png onwards into the directory at path using workers threads.
+    bool open(const std::string &path, CaptureFormat format, sf::Vector2u size, int fps, int workers, std::string &error);
+    bool isOpen() const { return !threads.empty(); }
+
+    // Capture what has been drawn to the window; call after drawing and before display().
+    // Never waits on encoding or the disk.
+    void captureWindow(const sf::Window &window);
+
+    // Capture a finished offscreen frame. Waits for queue space rather than dropping,
+    // for offline rendering where every frame must be kept.
+    void captureTexture(const sf::Texture &texture);
+
+    // Write every pending frame and stop the writers. Returns false if any write failed.
+    bool close();
+
+    int captured() const { return framesWritten.load(std::memory_order_relaxed); }
+    int dropped() const { return framesDropped.load(std::memory_order_relaxed); }
+    const std::string &writeError() const { return error; }
+
+private:
+    struct Frame
+    {
+        long long number;
+        sf::Image image;
+    };
+
+    void enqueue(Frame frame, bool wait);
+    void readBack(int slot, bool wait);
+    bool popFrame(Frame &frame);
+    void writeVideo();
+    void encodeImages();
+    void fail(const std::string &message);
+
+    CaptureFormat format = CaptureFormat::Y4M;
+    sf::Vector2u size;
+    std::string path;
+    long long nextFrame = 0;
+
+    // GPU copies not yet read back, and the frame number each holds
+    sf::Texture ring[CAPTURE_READBACK_DELAY];
+    long long ringFrame[CAPTURE_READBACK_DELAY] = {};
+    bool ringPending[CAPTURE_READBACK_DELAY] = {};
+
+    std::FILE *video = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable spaceFree;
+    std::deque<Frame> queue;
+    bool closing = false;
+    std::string error;
+    std::vector<std::thread> threads;
+
+    std::atomic<int> framesWritten{0};
+    std::atomic<int> framesDropped{0};
+};
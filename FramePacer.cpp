@@ -0,0 +1,85 @@
+#include "FramePacer.h"
+#include <thread>
+#include <algorithm>
+
+namespace
+{
+    const double SLEEP_QUANTUM = 0.001;
+    const double LATENCY_SAFETY_MARGIN = 0.001;
+
+    // Rise immediately on a slow sample, decay slowly on fast ones
+    double trackPeak(double estimate, double sample)
+    {
+        if (sample > estimate)
+            return sample;
+        return estimate * 0.98 + sample * 0.02;
+    }
+}
+
+FramePacer::FramePacer(PacingMode mode, double targetFps)
+    : mode(mode),
+      period(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps)))
+{
+    workStart = Clock::now();
+    nextDeadline = workStart + period;
+}
+
+void FramePacer::frameStart()
+{
+    if (mode == PacingMode::LatencyTarget)
+    {
+        // Start the frame just early enough for it to finish by the deadline
+        auto lead = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(workEstimate + LATENCY_SAFETY_MARGIN));
+        waitUntil(nextDeadline - lead);
+    }
+    workStart = Clock::now();
+}
+
+void FramePacer::frameEnd()
+{
+    Clock::time_point now = Clock::now();
+    workEstimate = trackPeak(workEstimate, std::chrono::duration<double>(now - workStart).count());
+
+    if (mode == PacingMode::Capped)
+    {
+        waitUntil(nextDeadline);
+        now = Clock::now();
+    }
+
+    nextDeadline += period;
+
+    // Fell more than a frame behind: drop the missed deadlines instead of rushing to catch up
+    if (nextDeadline < now)
+    {
+        nextDeadline = now + period;
+    }
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline)
+{
+    while (true)
+    {
+        Clock::time_point now = Clock::now();
+        double remaining = std::chrono::duration<double>(deadline - now).count();
+        if (remaining <= 0)
+            return;
+
+        if (remaining > sleepOvershoot + SLEEP_QUANTUM)
+        {
+            if (idle)
+            {
+                idle();
+                now = Clock::now();
+            }
+            std::this_thread::sleep_for(std::chrono::duration<double>(SLEEP_QUANTUM));
+            double slept = std::chrono::duration<double>(Clock::now() - now).count();
+            sleepOvershoot = trackPeak(sleepOvershoot, std::max(0.0, slept - SLEEP_QUANTUM));
+        }
+        else
+        {
+            // Spin out the last stretch for sub-millisecond accuracy
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <chrono>
+#include <functional>
+
+enum class PacingMode
+{
+    Capped,        // Present at a fixed rate, sleeping then spinning up to each deadline
+    Uncapped,      // Present as fast as possible
+    LatencyTarget  // Present at a fixed rate, but delay the start of each frame so input is sampled as late as possible
+};
+
+// Hybrid sleep/spin frame limiter. Coarse OS sleeps cover most of the wait and
+// a short spin covers the final stretch, with the spin margin adapted to how
+// much the OS actually oversleeps on this machine.
+class FramePacer
+{
+public:
+    FramePacer(PacingMode mode, double targetFps);
+
+    // Call before sampling input. Waits in LatencyTarget mode.
+    void frameStart();
+
+    // Call after presenting the frame. Waits in Capped mode.
+    void frameEnd();
+
+    // Called between sleeps while waiting, so the caller can keep draining input
+    void setIdleCallback(std::function<void()> callback) { idle = std::move(callback); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void waitUntil(Clock::time_point deadline);
+
+    PacingMode mode;
+    Clock::duration period;
+    Clock::time_point nextDeadline;
+    Clock::time_point workStart;
+    std::function<void()> idle;
+
+    // Running estimates in seconds
+    double sleepOvershoot = 0.002;
+    double workEstimate = 0.004;
+};
@@ -0,0 +1,157 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+    double toMilliseconds(FrameProfiler::Clock::duration elapsed)
+    {
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+
+    int bucketOf(double milliseconds)
+    {
+        return std::min(PROFILE_BUCKET_COUNT, (int)(milliseconds / PROFILE_BUCKET_MS));
+    }
+
+    bool endsWith(const std::string &text, const std::string &suffix)
+    {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+FrameProfiler::FrameProfiler()
+    : ring(PROFILE_RING_CAPACITY), histograms(PHASE_COUNT + 1)
+{
+    for (auto &histogram : histograms)
+    {
+        for (auto &bucket : histogram)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+    frameStart = Clock::now();
+}
+
+void FrameProfiler::beginFrame()
+{
+    std::uint32_t frame = current.frame;
+    current = FrameSample();
+    current.frame = frame + 1;
+    frameStart = Clock::now();
+}
+
+void FrameProfiler::discardFrame()
+{
+    // The next beginFrame reuses this frame's number, so recorded frames stay consecutive
+    std::uint32_t frame = current.frame;
+    current = FrameSample();
+    current.frame = frame - 1;
+    frameStart = Clock::now();
+}
+
+void FrameProfiler::add(ProfilePhase phase, Clock::duration elapsed)
+{
+    current.phases[phase] += (float)toMilliseconds(elapsed);
+}
+
+void FrameProfiler::endFrame()
+{
+    current.total = (float)toMilliseconds(Clock::now() - frameStart);
+
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        histograms[phase][bucketOf(current.phases[phase])].fetch_add(1, std::memory_order_relaxed);
+    }
+    histograms[PHASE_COUNT][bucketOf(current.total)].fetch_add(1, std::memory_order_relaxed);
+
+    // Write the slot, then count it
+    std::uint64_t index = published.load(std::memory_order_relaxed);
+    ring[index % PROFILE_RING_CAPACITY] = current;
+    published.store(index + 1, std::memory_order_release);
+}
+
+PhasePercentiles FrameProfiler::percentiles(int phase) const
+{
+    const auto &histogram = histograms[phase];
+    std::uint64_t total = 0;
+    for (const auto &bucket : histogram)
+        total += bucket.load(std::memory_order_relaxed);
+
+    PhasePercentiles result;
+    if (total == 0)
+        return result;
+
+    // Report the upper edge of the bucket holding each rank
+    const double ranks[3] = {0.50, 0.95, 0.99};
+    double *outputs[3] = {&result.p50, &result.p95, &result.p99};
+    std::uint64_t seen = 0;
+    int next = 0;
+    for (int bucket = 0; bucket <= PROFILE_BUCKET_COUNT && next < 3; bucket++)
+    {
+        seen += histogram[bucket].load(std::memory_order_relaxed);
+        while (next < 3 && seen >= (std::uint64_t)(ranks[next] * total + 0.5))
+        {
+            *outputs[next] = (bucket + 1) * PROFILE_BUCKET_MS;
+            next++;
+        }
+    }
+    return result;
+}
+
+std::vector<FrameSample> FrameProfiler::recentFrames() const
+{
+    std::uint64_t end = published.load(std::memory_order_acquire);
+    std::uint64_t begin = end > PROFILE_RING_CAPACITY ? end - PROFILE_RING_CAPACITY : 0;
+
+    std::vector<FrameSample> frames;
+    frames.reserve((size_t)(end - begin));
+    for (std::uint64_t i = begin; i < end; i++)
+    {
+        frames.push_back(ring[i % PROFILE_RING_CAPACITY]);
+    }
+    return frames;
+}
+
+bool FrameProfiler::exportTimings(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+        return false;
+
+    std::vector<FrameSample> frames = recentFrames();
+    bool json = endsWith(path, ".json");
+
+    if (json)
+    {
+        file << "{\n  \"summary\": {";
+        for (int phase = 0; phase <= PHASE_COUNT; phase++)
+        {
+            PhasePercentiles p = percentiles(phase);
+            file << (phase ? "," : "") << "\n    \"" << (phase < PHASE_COUNT ? PROFILE_PHASE_NAMES[phase] : "total")
+                 << "\": {\"p50\": " << p.p50 << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99 << "}";
+        }
+        file << "\n  },\n  \"frames\": [";
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            file << (i ? "," : "") << "\n    {\"frame\": " << frames[i].frame << ", \"total\": " << frames[i].total;
+            for (int phase = 0; phase < PHASE_COUNT; phase++)
+                file << ", \"" << PROFILE_PHASE_NAMES[phase] << "\": " << frames[i].phases[phase];
+            file << "}";
+        }
+        file << "\n  ]\n}\n";
+    }
+    else
+    {
+        file << "frame,total";
+        for (int phase = 0; phase < PHASE_COUNT; phase++)
+            file << "," << PROFILE_PHASE_NAMES[phase];
+        file << "\n";
+        for (const FrameSample &frame : frames)
+        {
+            file << frame.frame << "," << frame.total;
+            for (int phase = 0; phase < PHASE_COUNT; phase++)
+                file << "," << frame.phases[phase];
+            file << "\n";
+        }
+    }
+    return file.good();
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Phases of one game frame, in the order they run
+enum ProfilePhase
+{
+    PHASE_EVENTS,   // Window event polling
+    PHASE_INPUT,    // Keyboard sampling and replay recording
+    PHASE_PHYSICS,  // Player movement, gravity and landing
+    PHASE_RECYCLE,  // Camera scroll and platform recycling
+    PHASE_DRAW,     // Building and issuing draw calls
+    PHASE_DISPLAY,  // app.display()
+    PHASE_WAIT,     // Frame pacer sleeps
+    PHASE_COUNT
+};
+
+const char *const PROFILE_PHASE_NAMES[PHASE_COUNT] = {"events", "input", "physics", "recycle", "draw", "display", "wait"};
+
+// Frames kept for export; older frames are overwritten
+const std::size_t PROFILE_RING_CAPACITY = 1 << 16;
+
+// Histogram resolution: 50 us buckets up to 50 ms, plus one overflow bucket
+const double PROFILE_BUCKET_MS = 0.05;
+const int PROFILE_BUCKET_COUNT = 1000;
+
+// Timings of one frame in milliseconds
+struct FrameSample
+{
+    std::uint32_t frame = 0;
+    float total = 0;
+    float phases[PHASE_COUNT] = {};
+};
+
+struct PhasePercentiles
+{
+    double p50 = 0, p95 = 0, p99 = 0;
+};
+
+// Per-phase frame profiler. Scoped timers accumulate into the current frame,
+// endFrame() records it in a ring of recent frames and in per-phase histograms.
+// Not thread-safe: recording, the overlay and export all run on the game loop thread.
+class FrameProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FrameProfiler();
+
+    void beginFrame();
+    void endFrame();
+
+    // Drop the current frame unrecorded, for loop passes that present nothing
+    void discardFrame();
+
+    // Add time to a phase of the current frame; phases may be entered several times per frame
+    void add(ProfilePhase phase, Clock::duration elapsed);
+
+    // Percentiles of a phase (or of the whole frame for PHASE_COUNT) over every recorded frame
+    PhasePercentiles percentiles(int phase) const;
+
+    // Frames still held in the ring, oldest first
+    std::vector<FrameSample> recentFrames() const;
+
+    // Write every frame still in the ring as CSV, or as JSON with a percentile summary if the path ends in .json
+    bool exportTimings(const std::string &path) const;
+
+private:
+    std::vector<FrameSample> ring;
+    std::atomic<std::uint64_t> published{0};
+
+    // Histogram row PHASE_COUNT holds whole-frame times
+    std::vector<std::array<std::atomic<std::uint32_t>, PROFILE_BUCKET_COUNT + 1>> histograms;
+
+    FrameSample current;
+    Clock::time_point frameStart;
+};
+
+// Adds the time between construction and destruction to a phase
+class ProfileScope
+{
+public:
+    ProfileScope(FrameProfiler &profiler, ProfilePhase phase)
+        : profiler(profiler), phase(phase), start(FrameProfiler::Clock::now()) {}
+    ~ProfileScope() { profiler.add(phase, FrameProfiler::Clock::now() - start); }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    FrameProfiler &profiler;
+    ProfilePhase phase;
+    FrameProfiler::Clock::time_point start;
+};
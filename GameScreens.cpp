@@ -0,0 +1,363 @@
+#include "GameScreens.h"
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    // World batch layout: background first, then platforms, then the player on top
+    const size_t QUAD_BACKGROUND = 0;
+    const size_t QUAD_FIRST_PLATFORM = 1;
+    const size_t QUAD_PLAYER = QUAD_FIRST_PLATFORM + PLATFORM_CAPACITY;
+    const size_t WORLD_QUAD_COUNT = QUAD_PLAYER + 1;
+
+    const sf::Vector2f BUTTON_SIZE(BUTTON_WIDTH, BUTTON_HEIGHT);
+    const float BUTTON_X = (WINDOW_WIDTH - BUTTON_WIDTH) / 2;
+
+    // The mode button is wider so the longest mode name fits
+    const sf::Vector2f MODE_BUTTON_SIZE(200, 36);
+
+    // Effect bursts: count, color, speed, angle, spread, life, size
+    const float UP = -1.5707964f;
+    const ParticleBurst LANDING_BURST{14, sf::Color(220, 230, 255, 200), 160, UP, 1.2f, 0.35f, 3};
+    const ParticleBurst BONUS_BURST{60, sf::Color(255, 210, 60), 420, UP, 0.7f, 0.8f, 4};
+    const ParticleBurst GAME_OVER_BURST{400, sf::Color(255, 100, 100), 900, UP, 0.9f, 1.6f, 4};
+}
+
+bool decodeAtlas(const AssetArchive &archive, TextureAtlas &atlas, std::string &error)
+{
+    std::vector<sf::Image> images(std::size(ATLAS_FILES));
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        std::size_t size = 0;
+        const std::uint8_t *data = archive.find(ATLAS_FILES[i], size);
+        if (!data)
+        {
+            error = std::string("missing asset ") + ATLAS_FILES[i];
+            return false;
+        }
+        if (!images[i].loadFromMemory(data, size))
+        {
+            error = std::string("cannot decode ") + ATLAS_FILES[i];
+            return false;
+        }
+    }
+    return atlas.pack(images, error);
+}
+
+GameScreens::GameScreens(const sf::Font &font, const TextureAtlas &atlas)
+    : atlas(atlas),
+      worldBatch(WORLD_QUAD_COUNT),
+      resumeButton(atlas.getTexture()),
+      titleText(font, "DOODLE JUMP", 52, ACCENT_COLOR),
+      subtitleText(font, "Jump to the top!", 16, SECONDARY_TEXT_COLOR),
+      instructionsText(font, "Controls:", 14, ACCENT_COLOR),
+      controlsText(font, "LEFT/RIGHT Arrow Keys\nSPACE to Pause", 12, SECONDARY_TEXT_COLOR),
+      hsLabelText(font, "Best Score", 14, ACCENT_COLOR),
+      hsText(font, "", 32, HOVER_COLOR),
+      leaderboardLabel(font, "Top Runs", 14, ACCENT_COLOR),
+      leaderboardList(font, "", 12, SECONDARY_TEXT_COLOR),
+      playButton(font, "PLAY", sf::Vector2f(BUTTON_X, 170), BUTTON_SIZE, 36),
+      modeButton(font, "", sf::Vector2f((WINDOW_WIDTH - MODE_BUTTON_SIZE.x) / 2, 232), MODE_BUTTON_SIZE, 14),
+      loadingText(font, "Loading...", 16, SECONDARY_TEXT_COLOR),
+      scoreCounter(font, 24, ACCENT_COLOR, sf::Color(0, 0, 0, 150)),
+      scoreLabelText(font, "SCORE", 12, SECONDARY_TEXT_COLOR),
+      pausedText(font, "PAUSED", 50, HOVER_COLOR),
+      resumeLabel(font, "Click to Resume", 12, SECONDARY_TEXT_COLOR),
+      pauseExitButton(font, "EXIT", sf::Vector2f(BUTTON_X, 330), BUTTON_SIZE, 32),
+      gameOverText(font, "GAME OVER", 50, sf::Color(255, 100, 100)),
+      scoreLabel(font, "Your Score", 16, SECONDARY_TEXT_COLOR),
+      finalScoreText(font, "", 48, HOVER_COLOR),
+      rankText(font, "", 12, ACCENT_COLOR),
+      separator1(font, "_____________________________________________________________________", 14, SECONDARY_TEXT_COLOR),
+      highScoreLabel(font, "Best Score", 16, SECONDARY_TEXT_COLOR),
+      highScoreText(font, "", 36, ACCENT_COLOR),
+      playAgainButton(font, "PLAY AGAIN", sf::Vector2f(BUTTON_X, 350), BUTTON_SIZE, 22),
+      gameOverExitButton(font, "EXIT", sf::Vector2f(BUTTON_X, 410), BUTTON_SIZE, 32),
+      overlay(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT)),
+      pauseOverlay(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT))
+{
+    prewarmDigitGlyphs(font, {24, 32, 36, 48});
+
+    titleText.setCentered(WINDOW_WIDTH, 40);
+    subtitleText.setCentered(WINDOW_WIDTH, 110);
+    instructionsText.setPosition(sf::Vector2f(PADDING, 280));
+    controlsText.setPosition(sf::Vector2f(PADDING, 310));
+    hsLabelText.setPosition(sf::Vector2f(PADDING, 450));
+    hsText.setPosition(sf::Vector2f(PADDING, 470));
+    leaderboardLabel.setPosition(sf::Vector2f(WINDOW_WIDTH / 2 + PADDING, 280));
+    leaderboardList.setPosition(sf::Vector2f(WINDOW_WIDTH / 2 + PADDING, 310));
+    loadingText.setCentered(WINDOW_WIDTH, 185);
+
+    scoreCounter.setPosition(sf::Vector2f(10, 10), sf::Vector2f(3, 3));
+    scoreLabelText.setPosition(sf::Vector2f(10, 40));
+
+    pausedText.setCentered(WINDOW_WIDTH, 80);
+    resumeLabel.setCentered(WINDOW_WIDTH, 280);
+
+    gameOverText.setCentered(WINDOW_WIDTH, 50);
+    scoreLabel.setCentered(WINDOW_WIDTH, 130);
+    finalScoreText.setCentered(WINDOW_WIDTH, 160);
+    separator1.setCentered(WINDOW_WIDTH, 225);
+    highScoreLabel.setCentered(WINDOW_WIDTH, 250);
+    highScoreText.setCentered(WINDOW_WIDTH, 275);
+
+    setMode(MODE_NORMAL);
+
+    overlay.setFillColor(sf::Color(0, 0, 0, 180));
+    pauseOverlay.setFillColor(sf::Color(0, 0, 0, 200));
+}
+
+void GameScreens::atlasUploaded()
+{
+    resumeButton.setTexture(atlas.getTexture());
+    resumeButton.setTextureRect(atlas.region(ATLAS_RESUME));
+    float resumeWidth = resumeButton.getGlobalBounds().size.x;
+    resumeButton.setPosition(sf::Vector2f(WINDOW_WIDTH / 2 - resumeWidth / 2, 200));
+    hasAtlas = true;
+    cacheValid = false;
+}
+
+void GameScreens::setLeaderboard(const std::string &text)
+{
+    leaderboardList.setString(text);
+    cacheValid = false;
+}
+
+void GameScreens::setRank(int value)
+{
+    rank = value;
+    cacheValid = false;
+    rankText.setString(rank > 0 ? "Rank #" + std::to_string(rank) : "");
+    rankText.setCentered(WINDOW_WIDTH, 318);
+}
+
+void GameScreens::setMode(GameMode mode)
+{
+    modeButton.setLabel(std::string("MODE: ") + GAME_MODE_NAMES[mode]);
+}
+
+ScreenButton GameScreens::buttonAt(GameState state, sf::Vector2f point) const
+{
+    if (state == MENU && hasAtlas && playButton.contains(point))
+        return BUTTON_PLAY;
+    if (state == MENU && hasAtlas && modeButton.contains(point))
+        return BUTTON_MODE;
+    if (state == PAUSED && resumeButton.getGlobalBounds().contains(point))
+        return BUTTON_RESUME;
+    if (state == PAUSED && pauseExitButton.contains(point))
+        return BUTTON_EXIT;
+    if (state == GAME_OVER && playAgainButton.contains(point))
+        return BUTTON_PLAY_AGAIN;
+    if (state == GAME_OVER && gameOverExitButton.contains(point))
+        return BUTTON_EXIT;
+    return BUTTON_NONE;
+}
+
+void GameScreens::drawWorld(sf::RenderTarget &target, const ScreenView &view)
+{
+    // All world sprites go out in one draw call from the atlas, once it has finished loading
+    if (!hasAtlas)
+        return;
+
+    size_t worldQuads = 1;
+    worldBatch.setQuad(QUAD_BACKGROUND, sf::Vector2f(0, 0), atlas.region(ATLAS_BACKGROUND));
+    if ((view.state == PLAYING || view.state == PAUSED) && view.snapshot)
+    {
+        const SimSnapshot &snapshot = *view.snapshot;
+        float scrollOffset = snapshot.lastScroll * (1.0f - view.alpha);
+        for (int i = 0; i < PLATFORM_CAPACITY; i++)
+        {
+            if (i < snapshot.platformCount)
+                worldBatch.setQuad(QUAD_FIRST_PLATFORM + i, sf::Vector2f(snapshot.platformX[i], snapshot.platformY[i] - scrollOffset), atlas.region(ATLAS_PLATFORM));
+            else
+                worldBatch.hideQuad(QUAD_FIRST_PLATFORM + i);
+        }
+
+        float playerX = snapshot.prevX + (snapshot.x - snapshot.prevX) * view.alpha;
+        float playerY = snapshot.prevY + (snapshot.y - snapshot.prevY) * view.alpha;
+        worldBatch.setQuad(QUAD_PLAYER, sf::Vector2f(playerX, playerY), atlas.region(ATLAS_PLAYER));
+        worldQuads = WORLD_QUAD_COUNT;
+    }
+    worldBatch.draw(target, atlas.getTexture(), worldQuads);
+}
+
+void GameScreens::draw(sf::RenderTarget &target, const ScreenView &view)
+{
+    // The world moved on since the cached copy was drawn, even if the state and scores look the same
+    cacheValid = false;
+    drawScene(target, view);
+    drawEffects(target, view);
+    drawButtons(target, view);
+}
+
+void GameScreens::drawCached(sf::RenderTarget &target, const ScreenView &view)
+{
+    int score = view.snapshot ? view.snapshot->score : 0;
+    bool stale = !cacheValid || cachedState != view.state || cachedBestScore != view.bestScore || cachedScore != score;
+    if (stale)
+    {
+        const sf::Vector2u layerSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+        if (staticLayer.getSize() != layerSize && !staticLayer.resize(layerSize))
+        {
+            draw(target, view);
+            return;
+        }
+        drawScene(staticLayer, view);
+        staticLayer.display();
+        cacheValid = true;
+        cachedState = view.state;
+        cachedBestScore = view.bestScore;
+        cachedScore = score;
+    }
+
+    target.draw(sf::Sprite(staticLayer.getTexture()));
+    drawEffects(target, view);
+    drawButtons(target, view);
+}
+
+void GameScreens::updateEffects(const ScreenView &view, float seconds)
+{
+    const SimSnapshot *snapshot = view.snapshot;
+    if (view.state == MENU || !snapshot)
+    {
+        effects.clear();
+        return;
+    }
+
+    // A new game starts from its own counters rather than replaying them
+    if (snapshot->run != effectsRun)
+    {
+        effects.clear();
+        effectsRun = snapshot->run;
+        effectsLandings = snapshot->landings;
+        effectsClimb = snapshot->heightClimbed;
+        gameOverBurst = false;
+    }
+
+    // Particles are in screen space, so they move down with the platforms as the camera climbs
+    effects.shift(0, (float)(snapshot->heightClimbed - effectsClimb));
+    effectsClimb = snapshot->heightClimbed;
+
+    if (snapshot->landings != effectsLandings)
+    {
+        effectsLandings = snapshot->landings;
+        sf::Vector2f contact(snapshot->landingX, snapshot->landingY);
+        effects.emit(contact, LANDING_BURST);
+        if (snapshot->landingBonus)
+            effects.emit(contact, BONUS_BURST);
+    }
+    if (snapshot->gameOver && !gameOverBurst)
+    {
+        effects.emit(sf::Vector2f(snapshot->x + PLAYER_WIDTH / 2, WINDOW_HEIGHT), GAME_OVER_BURST);
+        gameOverBurst = true;
+    }
+
+    if (view.state != PAUSED)
+        effects.update(seconds);
+}
+
+void GameScreens::drawEffects(sf::RenderTarget &target, const ScreenView &view)
+{
+    // Drawn with the same scroll interpolation as the platforms
+    sf::RenderStates states;
+    if ((view.state == PLAYING || view.state == PAUSED) && view.snapshot)
+        states.transform.translate(sf::Vector2f(0, -view.snapshot->lastScroll * (1.0f - view.alpha)));
+    effects.draw(target, states);
+}
+
+bool GameScreens::updateHover(const ScreenView &view)
+{
+    bool changed = false;
+    if (view.state == MENU && hasAtlas)
+    {
+        changed = playButton.updateHover(view.mousePos);
+        changed = modeButton.updateHover(view.mousePos) || changed;
+    }
+    else if (view.state == PAUSED)
+    {
+        changed = pauseExitButton.updateHover(view.mousePos);
+    }
+    else if (view.state == GAME_OVER)
+    {
+        changed = playAgainButton.updateHover(view.mousePos);
+        changed = gameOverExitButton.updateHover(view.mousePos) || changed;
+    }
+    return changed;
+}
+
+void GameScreens::drawScene(sf::RenderTarget &target, const ScreenView &view)
+{
+    target.clear(sf::Color(20, 20, 40));
+    drawWorld(target, view);
+
+    if (view.state == MENU)
+    {
+        titleText.draw(target);
+        subtitleText.draw(target);
+
+        if (!hasAtlas)
+        {
+            loadingText.draw(target);
+        }
+
+        instructionsText.draw(target);
+        controlsText.draw(target);
+
+        hsLabelText.draw(target);
+        hsText.setNumber(view.bestScore);
+        hsText.draw(target);
+
+        leaderboardLabel.draw(target);
+        leaderboardList.draw(target);
+    }
+    else if (view.state == PLAYING || view.state == PAUSED)
+    {
+        scoreCounter.setValue(view.snapshot ? view.snapshot->score : 0);
+        scoreCounter.draw(target);
+        scoreLabelText.draw(target);
+
+        if (view.state == PAUSED)
+        {
+            target.draw(overlay);
+            pausedText.draw(target);
+            target.draw(resumeButton);
+            resumeLabel.draw(target);
+        }
+    }
+    else if (view.state == GAME_OVER)
+    {
+        target.draw(pauseOverlay);
+
+        gameOverText.draw(target);
+        scoreLabel.draw(target);
+        finalScoreText.setNumber(view.snapshot ? view.snapshot->score : 0);
+        finalScoreText.draw(target);
+        separator1.draw(target);
+        highScoreLabel.draw(target);
+        highScoreText.setNumber(view.bestScore);
+        highScoreText.draw(target);
+        if (rank > 0)
+        {
+            rankText.draw(target);
+        }
+    }
+}
+
+void GameScreens::drawButtons(sf::RenderTarget &target, const ScreenView &view)
+{
+    updateHover(view);
+    if (view.state == MENU && hasAtlas)
+    {
+        playButton.draw(target);
+        modeButton.draw(target);
+    }
+    else if (view.state == PAUSED)
+    {
+        pauseExitButton.draw(target);
+    }
+    else if (view.state == GAME_OVER)
+    {
+        playAgainButton.draw(target);
+        gameOverExitButton.draw(target);
+    }
+}
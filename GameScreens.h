@@ -0,0 +1,148 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "AssetArchive.h"
+#include "ParticlePool.h"
+#include "SimThread.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "Ui.h"
+#include <string>
+
+enum GameState
+{
+    MENU,
+    PLAYING,
+    PAUSED,
+    GAME_OVER
+};
+
+// Images packed into the texture atlas, in load order
+enum AtlasImage
+{
+    ATLAS_BACKGROUND,
+    ATLAS_PLATFORM,
+    ATLAS_PLAYER,
+    ATLAS_RESUME
+};
+const char *const ATLAS_FILES[] = {ASSET_BACKGROUND, ASSET_PLATFORM, ASSET_PLAYER, ASSET_RESUME};
+
+// Decode the atlas images from the archive and pack them. Runs on a worker thread,
+// so it only touches CPU-side images; the texture upload happens on the main thread.
+bool decodeAtlas(const AssetArchive &archive, TextureAtlas &atlas, std::string &error);
+
+// Buttons the player can click, as returned by GameScreens::buttonAt
+enum ScreenButton
+{
+    BUTTON_NONE,
+    BUTTON_PLAY,
+    BUTTON_MODE,
+    BUTTON_RESUME,
+    BUTTON_EXIT,
+    BUTTON_PLAY_AGAIN
+};
+
+// What one frame shows
+struct ScreenView
+{
+    GameState state = MENU;
+
+    // Latest tick of the current game, or null before its first tick has been published
+    const SimSnapshot *snapshot = nullptr;
+
+    // Interpolation between the snapshot's previous and current tick
+    float alpha = 0;
+
+    sf::Vector2f mousePos;
+    int bestScore = 0;
+};
+
+// Widgets and world sprites of every game screen and the code that draws them.
+// Shared by the game and the render benchmarks, so both draw exactly the same frame.
+class GameScreens
+{
+public:
+    GameScreens(const sf::Font &font, const TextureAtlas &atlas);
+
+    // Call once the atlas texture is uploaded; until then the menu shows a loading message
+    void atlasUploaded();
+    bool assetsLoaded() const { return hasAtlas; }
+
+    void setLeaderboard(const std::string &text);
+
+    // Leaderboard rank of the game just finished; 0 hides it
+    void setRank(int rank);
+
+    // Game mode shown on the menu's mode button
+    void setMode(GameMode mode);
+
+    // Clear the target and draw the screen for the given state
+    void draw(sf::RenderTarget &target, const ScreenView &view);
+
+    // Same as draw(), but everything except the buttons comes from an offscreen copy
+    // that is only redrawn when the state or a shown score changes. For screens that
+    // are static apart from button hover: menu, pause (over the frozen game) and game over.
+    // Any draw() in between discards the copy.
+    void drawCached(sf::RenderTarget &target, const ScreenView &view);
+
+    // Update button hover from the mouse position; returns whether any button changed
+    bool updateHover(const ScreenView &view);
+
+    // Spawn effects for the landings and game over the snapshot shows since the last
+    // call, then advance them; call once per frame before drawing
+    void updateEffects(const ScreenView &view, float seconds);
+
+    // Whether any effect is still playing, so the screen cannot be treated as static.
+    // Effects do not advance while paused, so a paused screen is static regardless.
+    bool effectsActive() const { return !effects.empty(); }
+
+    ScreenButton buttonAt(GameState state, sf::Vector2f point) const;
+
+private:
+    void drawScene(sf::RenderTarget &target, const ScreenView &view);
+    void drawWorld(sf::RenderTarget &target, const ScreenView &view);
+    void drawButtons(sf::RenderTarget &target, const ScreenView &view);
+    void drawEffects(sf::RenderTarget &target, const ScreenView &view);
+
+    const TextureAtlas &atlas;
+    bool hasAtlas = false;
+    int rank = 0;
+
+    // Offscreen copy of the screen without its buttons, for drawCached()
+    sf::RenderTexture staticLayer;
+    bool cacheValid = false;
+    GameState cachedState = MENU;
+    int cachedBestScore = 0;
+    int cachedScore = 0;
+
+    SpriteBatch worldBatch;
+
+    // Landing, bonus and game over particles, and the game events they were made for
+    ParticlePool effects;
+    std::uint32_t effectsRun = 0;
+    int effectsLandings = 0;
+    int effectsClimb = 0;
+    bool gameOverBurst = false;
+
+    sf::Sprite resumeButton;
+
+    // Menu screen
+    Label titleText, subtitleText, instructionsText, controlsText;
+    Label hsLabelText, hsText, leaderboardLabel, leaderboardList;
+    Button playButton, modeButton;
+    Label loadingText;
+
+    // In-game HUD
+    ScoreCounter scoreCounter;
+    Label scoreLabelText;
+
+    // Pause screen
+    Label pausedText, resumeLabel;
+    Button pauseExitButton;
+
+    // Game over screen
+    Label gameOverText, scoreLabel, finalScoreText, rankText, separator1, highScoreLabel, highScoreText;
+    Button playAgainButton, gameOverExitButton;
+
+    sf::RectangleShape overlay;
+    sf::RectangleShape pauseOverlay;
+};
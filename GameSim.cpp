@@ -0,0 +1,463 @@
+#include "GameSim.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+std::uint32_t Rng::next()
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (std::uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+int PlatformRing::firstAbove(int y) const
+{
+    // y decreases with index, so binary search for the first entry with a smaller y
+    int low = 0, high = count;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (this->y(mid) < y)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+}
+
+namespace
+{
+    // Independent generator for one chunk of a level
+    Rng chunkRng(std::uint64_t levelSeed, int index)
+    {
+        Rng rng;
+        rng.seed(levelSeed ^ ((std::uint64_t)(index + 1) * 0xD1B54A32D192ED03ULL));
+        return rng;
+    }
+
+    // Horizontal position of the platform a chunk starts with. The first chunk starts
+    // on the spawn platform under the player.
+    int chunkAnchorX(std::uint64_t levelSeed, int index)
+    {
+        if (index == 0)
+            return WINDOW_WIDTH / 2 - PLATFORM_WIDTH / 2;
+        return chunkRng(levelSeed, index).nextInt(SCREEN_BOUNDARY_RIGHT - PLATFORM_WIDTH);
+    }
+
+    Platform platformAt(int x, int altitude)
+    {
+        return Platform{x, -altitude, false};
+    }
+
+    bool reachableBetween(const Platform &from, const Platform &to, const Platform *next, const GameParams &params)
+    {
+        return isReachable(from, to, params) && (!next || isReachable(to, *next, params));
+    }
+
+    // Find a spot for a platform that can be reached from the last one (and, if given,
+    // reaches the next one), searching outwards from the wanted altitude within
+    // [lowest, highest]. Landing depends on where the fall step crosses the platform's
+    // top edge, so nearby heights can succeed where the wanted one fails.
+    bool placePlatform(Rng &rng, const Platform &from, const Platform *next, int wanted, int lowest, int highest,
+                       const GameParams &params, int &x, int &altitude)
+    {
+        const int attempts = 4;
+        const int step = PLATFORM_HEIGHT / 2;
+        for (int offset = 0; wanted - offset >= lowest || wanted + offset <= highest; offset += step)
+        {
+            for (int candidate : {wanted - offset, wanted + offset})
+            {
+                if (candidate < lowest || candidate > highest || (offset == 0 && candidate != wanted - offset))
+                    continue;
+
+                altitude = candidate;
+                for (int attempt = 0; attempt < attempts; attempt++)
+                {
+                    x = rng.nextInt(SCREEN_BOUNDARY_RIGHT - PLATFORM_WIDTH);
+                    if (reachableBetween(from, platformAt(x, altitude), next, params))
+                        return true;
+                }
+
+                // Straight above either end needs no sideways travel
+                x = from.x;
+                if (reachableBetween(from, platformAt(x, altitude), next, params))
+                    return true;
+                if (next)
+                {
+                    x = next->x;
+                    if (reachableBetween(from, platformAt(x, altitude), next, params))
+                        return true;
+                }
+            }
+        }
+
+        // Nothing fits; only happens when the physics cannot clear MIN_PLATFORM_GAP at all
+        x = from.x;
+        altitude = std::clamp(wanted, lowest, std::max(lowest, highest));
+        return false;
+    }
+
+    // Player physics of a mode, as compile-time constants
+    template <const GameConfig &Config>
+    struct ConfigPhysics
+    {
+        static constexpr float gravity = Config.gravity;
+        static constexpr float jumpPower = Config.jumpPower;
+        static constexpr int playerSpeed = Config.playerSpeed;
+    };
+
+    // Player physics read from GameParams, for tuning runs with custom values
+    struct ParamsPhysics
+    {
+        float gravity;
+        float jumpPower;
+        int playerSpeed;
+    };
+
+    // Whether two sets of params play the same; the step length is left out, every update takes it at run time
+    bool sameParams(const GameParams &a, const GameParams &b)
+    {
+        return a.platformSpacing == b.platformSpacing && a.minPlatforms == b.minPlatforms &&
+               a.difficultyScoreThreshold == b.difficultyScoreThreshold && a.jumpPower == b.jumpPower &&
+               a.gravity == b.gravity && a.playerSpeed == b.playerSpeed;
+    }
+}
+
+bool isReachable(const Platform &from, const Platform &to, const GameParams &params)
+{
+    float gap = (float)(from.y - to.y);
+    int horizontalGap = std::max(0, std::abs(from.x - to.x) - PLATFORM_WIDTH);
+
+    // Follow the jump arc the player flies: the feet must come back down through the
+    // target's top edge, late enough to have covered the horizontal gap
+    float jump = params.jumpPower;
+    float discriminant = jump * jump - 2 * params.gravity * gap;
+    if (discriminant < 0)
+        return false;
+    float landingTick = (jump + std::sqrt(discriminant)) / params.gravity;
+    return landingTick * params.playerSpeed >= horizontalGap;
+}
+
+int maxJumpHeight(const GameParams &params)
+{
+    return (int)(params.jumpPower * params.jumpPower / (2 * params.gravity));
+}
+
+LevelChunk generateChunk(std::uint64_t levelSeed, int index, const GameParams &params)
+{
+    LevelChunk chunk;
+    chunk.index = index;
+    Rng rng = chunkRng(levelSeed, index);
+    rng.next(); // Used by chunkAnchorX
+
+    int bottom = index * CHUNK_HEIGHT;
+    int top = bottom + CHUNK_HEIGHT;
+    chunk.x[0] = chunkAnchorX(levelSeed, index);
+    chunk.altitude[0] = bottom;
+    chunk.count = 1;
+
+    // Difficulty rises with height: about one threshold's worth of score per level,
+    // and fewer platforms per screen at each level
+    int level = bottom / std::max(1, params.platformSpacing * params.difficultyScoreThreshold);
+    int perScreen = std::max(params.minPlatforms, PLATFORM_COUNT - level);
+    int spacing = std::max(params.platformSpacing, CHUNK_HEIGHT / std::max(1, perScreen));
+    int maxGap = std::max(MIN_PLATFORM_GAP, maxJumpHeight(params) - PLATFORM_HEIGHT);
+    Platform next = platformAt(chunkAnchorX(levelSeed, index + 1), top);
+
+    while (chunk.count < CHUNK_CAPACITY)
+    {
+        Platform last = platformAt(chunk.x[chunk.count - 1], chunk.altitude[chunk.count - 1]);
+        int lowest = -last.y + MIN_PLATFORM_GAP;
+
+        // Varied spacing around the nominal gap, kept within what a jump can clear
+        int gap = spacing - spacing / 4 + rng.nextInt(spacing / 2 + 1);
+        gap = std::clamp(gap, MIN_PLATFORM_GAP, maxGap);
+
+        int x = 0, altitude = -last.y + gap;
+        if (altitude > top - MIN_PLATFORM_GAP)
+        {
+            // Close the chunk. If the next chunk's first platform is out of reach, bridge to it,
+            // or when there is no room for a bridge, move the last platform instead.
+            if (!isReachable(last, next, params))
+            {
+                if (lowest <= top - MIN_PLATFORM_GAP)
+                {
+                    placePlatform(rng, last, &next, (-last.y + top) / 2, lowest, top - MIN_PLATFORM_GAP, params, x, altitude);
+                    chunk.x[chunk.count] = x;
+                    chunk.altitude[chunk.count] = altitude;
+                    chunk.count++;
+                }
+                else if (chunk.count > 1)
+                {
+                    Platform before = platformAt(chunk.x[chunk.count - 2], chunk.altitude[chunk.count - 2]);
+                    placePlatform(rng, before, &next, -last.y, -before.y + MIN_PLATFORM_GAP, top - MIN_PLATFORM_GAP, params, x, altitude);
+                    chunk.x[chunk.count - 1] = x;
+                    chunk.altitude[chunk.count - 1] = altitude;
+                }
+            }
+            break;
+        }
+
+        placePlatform(rng, last, nullptr, altitude, lowest, std::min(-last.y + maxGap, top - MIN_PLATFORM_GAP), params, x, altitude);
+        chunk.x[chunk.count] = x;
+        chunk.altitude[chunk.count] = altitude;
+        chunk.count++;
+    }
+    return chunk;
+}
+
+GameSim::GameSim(std::uint64_t seed, const GameParams &params)
+{
+    setParams(params);
+    rng.seed(seed);
+    reset();
+}
+
+void GameSim::setParams(const GameParams &newParams)
+{
+    params = newParams;
+
+    // Runtime dispatch to the compiled modes happens here, not per tick
+    static const MoveKernel modeKernels[MODE_COUNT] = {
+        &GameSim::movePlayerFor<NORMAL_CONFIG>,
+        &GameSim::movePlayerFor<EASY_CONFIG>,
+        &GameSim::movePlayerFor<HARD_CONFIG>,
+        &GameSim::movePlayerFor<LOW_GRAVITY_CONFIG>,
+    };
+    currentMode = MODE_COUNT;
+    moveKernel = &GameSim::movePlayerCustom;
+    for (int mode = 0; mode < MODE_COUNT; mode++)
+    {
+        if (sameParams(params, GAME_MODE_CONFIGS[mode]->params()))
+        {
+            currentMode = (GameMode)mode;
+            moveKernel = modeKernels[mode];
+            break;
+        }
+    }
+}
+
+void GameSim::reset()
+{
+    currentScore = 0;
+    frameCounter = 0;
+    lastPlatformY = WINDOW_HEIGHT - 80;
+
+    x = WINDOW_WIDTH / 2;
+    y = WINDOW_HEIGHT - 80 - PLAYER_HEIGHT;
+    peakY = y;
+    dx = 0;
+    dy = 0;
+    gameOver = false;
+
+    prevX = x;
+    prevY = y;
+    lastScroll = 0;
+
+    landings = 0;
+    landingX = 0;
+    landingY = 0;
+    landingBonus = false;
+
+    heightClimbed = 0;
+    gapsSpawned = 0;
+    unreachableGaps = 0;
+
+    // Each game climbs its own level, drawn from the game's random stream
+    levelSeed = ((std::uint64_t)rng.next() << 32) | rng.next();
+    chunk = generateChunk(levelSeed, 0, params);
+    chunkCursor = 0;
+    platforms.clear();
+    spawnPlatforms();
+}
+
+void GameSim::reset(std::uint64_t seed)
+{
+    rng.seed(seed);
+    reset();
+}
+
+void GameSim::step(const GameInput &input)
+{
+    movePlayer(input);
+    scrollCamera();
+}
+
+void GameSim::movePlayer(const GameInput &input)
+{
+    (this->*moveKernel)(input);
+}
+
+template <const GameConfig &Config>
+void GameSim::movePlayerFor(const GameInput &input)
+{
+    movePlayerWith(ConfigPhysics<Config>(), input);
+}
+
+void GameSim::movePlayerCustom(const GameInput &input)
+{
+    movePlayerWith(ParamsPhysics{params.gravity, params.jumpPower, params.playerSpeed}, input);
+}
+
+template <class Physics>
+void GameSim::movePlayerWith(const Physics &physics, const GameInput &input)
+{
+    frameCounter++;
+
+    prevX = x;
+    prevY = y;
+    lastScroll = 0;
+
+    // Exact ballistic motion over the step, so the path is the same for any step length
+    const float dt = params.timeStep;
+    const float g = physics.gravity;
+    const float startX = x;
+    const float startFeet = y + PLAYER_HEIGHT;
+    const float startDy = dy;
+    const float vx = (float)(((int)input.right - (int)input.left) * physics.playerSpeed);
+
+    // Clamp player position within horizontal bounds
+    x = std::clamp(startX + vx * dt, (float)SCREEN_BOUNDARY_LEFT, (float)SCREEN_BOUNDARY_RIGHT);
+    dy = startDy + g * dt;
+    y = startFeet + startDy * dt + 0.5f * g * dt * dt - PLAYER_HEIGHT;
+    peakY = std::min(prevY, y);
+    if (startDy < 0 && dy > 0)
+        peakY = startFeet - startDy * startDy / (2 * g) - PLAYER_HEIGHT;
+
+    // Swept landing: find the first platform top the feet cross while falling during the step.
+    // Falling starts at the apex when it lies within the step. After a bounce the rest of
+    // the step is swept again from the contact, so a long step can land more than once.
+    float fromX = startX, fromFeet = startFeet, fromDy = startDy, left = dt;
+    while (dy > 0)
+    {
+        // Scroll up to the apex first, as single ticks would have by now: the platforms it
+        // brings into view can be landed on, the ones it drops off the bottom cannot
+        fromFeet += (float)scrollCamera();
+        float fallStart = fromDy < 0 ? fromFeet - fromDy * fromDy / (2 * g) : fromFeet;
+        float endFeet = y + PLAYER_HEIGHT;
+
+        // Lower index is lower on screen, so walk down from the highest platform at or below fallStart
+        int landed = -1;
+        float contact = 0, contactX = 0;
+        for (int i = platforms.firstAbove((int)std::ceil(fallStart)) - 1; i >= 0 && platforms.y(i) <= endFeet; i--)
+        {
+            float top = (float)platforms.y(i);
+            contact = std::clamp((-fromDy + std::sqrt(std::max(0.0f, fromDy * fromDy + 2 * g * (top - fromFeet)))) / g, 0.0f, left);
+            contactX = std::clamp(fromX + vx * contact, (float)SCREEN_BOUNDARY_LEFT, (float)SCREEN_BOUNDARY_RIGHT);
+            float playerCenter = contactX + PLAYER_WIDTH / 2;
+            if (playerCenter > platforms.x(i) && playerCenter < platforms.x(i) + PLATFORM_WIDTH)
+            {
+                landed = i;
+                break;
+            }
+        }
+        if (landed < 0)
+            break;
+
+        // Bounce at the contact height and fly the rest of the step
+        float top = (float)platforms.y(landed);
+        float rest = left - contact;
+        dy = -physics.jumpPower + g * rest;
+        y = top - PLAYER_HEIGHT - physics.jumpPower * rest + 0.5f * g * rest * rest;
+        peakY = std::min(peakY, dy > 0 ? top - PLAYER_HEIGHT - physics.jumpPower * physics.jumpPower / (2 * g) : y);
+
+        landings++;
+        landingX = contactX + PLAYER_WIDTH / 2;
+        landingY = top;
+        landingBonus = false;
+
+        // Only award points once per platform touch
+        if (!platforms.isScored(landed))
+        {
+            // Longer jumps are rewarded with more points
+            int jumpDistance = lastPlatformY - platforms.y(landed);
+
+            if (jumpDistance >= 80)
+            {
+                currentScore += 2;
+                landingBonus = true;
+            }
+            else
+            {
+                currentScore += 1;
+            }
+
+            lastPlatformY = platforms.y(landed);
+            platforms.isScored(landed) = true;
+        }
+
+        fromX = contactX;
+        fromFeet = top;
+        fromDy = -physics.jumpPower;
+        left = rest;
+    }
+
+    // End game when player falls off screen
+    if (y > WINDOW_HEIGHT)
+    {
+        gameOver = true;
+    }
+}
+
+int GameSim::scrollCamera()
+{
+    // Camera follows player upward - scroll platforms down relative to camera
+    if (peakY >= CAMERA_THRESHOLD)
+        return 0;
+
+    // Platforms sit on whole pixels, so scroll whole pixels and keep the player's remainder.
+    // A long step can scroll more than once; lastScroll adds up the whole step.
+    int scroll = (int)std::ceil(CAMERA_THRESHOLD - peakY);
+    lastScroll += scroll;
+    peakY += scroll;
+    heightClimbed += scroll;
+    y += scroll;
+    landingY += scroll;
+
+    for (int i = 0; i < platforms.size(); i++)
+    {
+        platforms.y(i) += scroll;
+    }
+
+    // Drop platforms that scrolled off the bottom, then bring in the ones coming into view
+    while (platforms.size() > 0 && platforms.bottom().y > WINDOW_HEIGHT)
+    {
+        platforms.popBottom();
+    }
+    spawnPlatforms();
+    return scroll;
+}
+
+void GameSim::spawnPlatforms()
+{
+    // Altitude 0 is the starting platform's top, on screen at WINDOW_HEIGHT - 80 before any climb
+    const int baseY = WINDOW_HEIGHT - 80 + heightClimbed;
+    while (true)
+    {
+        if (chunkCursor == chunk.count)
+        {
+            // Only ready chunks are taken from the source, so the tick never waits on generation
+            int index = chunk.index + 1;
+            if (!chunkSource || !chunkSource(levelSeed, index, chunk))
+                chunk = generateChunk(levelSeed, index, params);
+            chunkCursor = 0;
+        }
+
+        Platform spawned;
+        spawned.x = chunk.x[chunkCursor];
+        spawned.y = baseY - chunk.altitude[chunkCursor];
+        spawned.scored = false;
+        if (spawned.y < -PLATFORM_SPAWN_MARGIN)
+            return;
+
+        if (platforms.size() > 0)
+        {
+            gapsSpawned++;
+            if (!isReachable(platforms.top(), spawned))
+                unreachableGaps++;
+        }
+        platforms.pushTop(spawned);
+        chunkCursor++;
+    }
+}
@@ -0,0 +1,333 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+// Game constants
+const int WINDOW_WIDTH = 400;
+const int WINDOW_HEIGHT = 533;
+const int PLATFORM_COUNT = 10;
+const int PLATFORM_SPACING = 60;
+const int MIN_PLATFORMS = 4;
+const int PLAYER_WIDTH = 50;
+const int PLAYER_HEIGHT = 70;
+const int PLATFORM_WIDTH = 68;
+const int PLATFORM_HEIGHT = 14;
+const float GRAVITY = 0.2f;
+const float JUMP_POWER = 11.0f;
+const int PLAYER_SPEED = 4;
+const int SCREEN_BOUNDARY_RIGHT = 350;
+const int SCREEN_BOUNDARY_LEFT = 0;
+const int CAMERA_THRESHOLD = 200;
+const int SCORE_INCREMENT = 1;
+const int DIFFICULTY_SCORE_THRESHOLD = 100;
+const int TICK_RATE = 60;
+const double TICK_SECONDS = 1.0 / TICK_RATE;
+
+// Ring slots for platforms; a power of two of at least PLATFORM_COUNT so wrapping is a mask
+const int PLATFORM_CAPACITY = 16;
+static_assert((PLATFORM_CAPACITY & (PLATFORM_CAPACITY - 1)) == 0 && PLATFORM_CAPACITY >= PLATFORM_COUNT,
+              "PLATFORM_CAPACITY must be a power of two no smaller than PLATFORM_COUNT");
+
+// Y coordinate of unused ring slots: far above the world so slot-wide scans never hit them
+const int EMPTY_PLATFORM_Y = -1000000;
+
+struct Platform
+{
+    int x, y;
+    bool scored;
+};
+
+// Platforms kept ordered by height in a fixed ring: index 0 is the lowest on screen
+// (largest y) and the last index the highest. Platforms only ever leave at the
+// bottom and enter at the top, so recycling is an O(1) pop and push.
+// Storage is structure-of-arrays by physical slot so collision kernels can scan
+// every slot with SIMD; logical index i lives in slot(i).
+struct PlatformRing
+{
+    alignas(32) int xs[PLATFORM_CAPACITY];
+    alignas(32) int ys[PLATFORM_CAPACITY];
+    bool scored[PLATFORM_CAPACITY];
+    int head = 0;
+    int count = 0;
+
+    PlatformRing() { clear(); }
+
+    int size() const { return count; }
+    int slot(int i) const { return (head + i) & (PLATFORM_CAPACITY - 1); }
+
+    int &x(int i) { return xs[slot(i)]; }
+    int x(int i) const { return xs[slot(i)]; }
+    int &y(int i) { return ys[slot(i)]; }
+    int y(int i) const { return ys[slot(i)]; }
+    bool &isScored(int i) { return scored[slot(i)]; }
+
+    Platform get(int i) const { return Platform{xs[slot(i)], ys[slot(i)], scored[slot(i)]}; }
+    Platform bottom() const { return get(0); }
+    Platform top() const { return get(count - 1); }
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+        for (int i = 0; i < PLATFORM_CAPACITY; i++)
+        {
+            xs[i] = 0;
+            ys[i] = EMPTY_PLATFORM_Y;
+            scored[i] = false;
+        }
+    }
+    void pushTop(const Platform &platform)
+    {
+        int s = slot(count++);
+        xs[s] = platform.x;
+        ys[s] = platform.y;
+        scored[s] = platform.scored;
+    }
+    void popBottom()
+    {
+        ys[head] = EMPTY_PLATFORM_Y;
+        head = (head + 1) & (PLATFORM_CAPACITY - 1);
+        count--;
+    }
+
+    // Index of the lowest platform whose top edge is above the given y, or size() if none
+    int firstAbove(int y) const;
+};
+
+// Levels are generated in chunks of one screen height, ahead of the camera
+const int CHUNK_HEIGHT = WINDOW_HEIGHT;
+
+// Closest two platforms may be stacked; bounds how many fit on screen at once
+const int MIN_PLATFORM_GAP = 3 * PLATFORM_HEIGHT;
+const int CHUNK_CAPACITY = CHUNK_HEIGHT / MIN_PLATFORM_GAP + 1;
+
+// Platforms enter the ring this far above the top of the screen, so they never pop in
+const int PLATFORM_SPAWN_MARGIN = 60;
+static_assert((WINDOW_HEIGHT + PLATFORM_SPAWN_MARGIN) / MIN_PLATFORM_GAP + 2 <= PLATFORM_CAPACITY,
+              "A screen of platforms at MIN_PLATFORM_GAP must fit in the platform ring");
+
+// Small self-contained PRNG (splitmix64) so every simulation owns its own reproducible stream
+struct Rng
+{
+    std::uint64_t state = 0;
+
+    void seed(std::uint64_t value) { state = value; }
+    std::uint32_t next();
+
+    // Uniform integer in [0, bound)
+    int nextInt(int bound) { return (int)(next() % (std::uint32_t)bound); }
+};
+
+// Tunable gameplay parameters, defaulting to the shipped constants
+struct GameParams
+{
+    int platformSpacing = PLATFORM_SPACING;
+    int minPlatforms = MIN_PLATFORMS;
+    int difficultyScoreThreshold = DIFFICULTY_SCORE_THRESHOLD;
+    float jumpPower = JUMP_POWER;
+    float gravity = GRAVITY;
+    int playerSpeed = PLAYER_SPEED;
+
+    // Ticks of TICK_SECONDS each step() advances. Landing is swept along the whole
+    // step, so headless runs can take longer steps without falling through platforms.
+    float timeStep = 1.0f;
+};
+
+// A game mode's physics and level tuning, fixed at compile time. The player
+// update is instantiated once per mode with its config as template argument,
+// so each mode's tick runs with the constants folded in.
+struct GameConfig
+{
+    float gravity;
+    float jumpPower;
+    int playerSpeed;
+    int platformSpacing;
+    int minPlatforms;
+    int difficultyScoreThreshold;
+
+    constexpr GameParams params() const
+    {
+        GameParams p;
+        p.platformSpacing = platformSpacing;
+        p.minPlatforms = minPlatforms;
+        p.difficultyScoreThreshold = difficultyScoreThreshold;
+        p.jumpPower = jumpPower;
+        p.gravity = gravity;
+        p.playerSpeed = playerSpeed;
+        return p;
+    }
+};
+
+inline constexpr GameConfig NORMAL_CONFIG{GRAVITY, JUMP_POWER, PLAYER_SPEED, PLATFORM_SPACING, MIN_PLATFORMS, DIFFICULTY_SCORE_THRESHOLD};
+inline constexpr GameConfig EASY_CONFIG{0.18f, 11.5f, 5, 50, 6, 200};
+inline constexpr GameConfig HARD_CONFIG{0.22f, 11.0f, 4, 70, 3, 60};
+
+// Floaty jumps that peak about as high as normal ones
+inline constexpr GameConfig LOW_GRAVITY_CONFIG{0.1f, 7.8f, 4, 60, 4, 100};
+
+enum GameMode
+{
+    MODE_NORMAL,
+    MODE_EASY,
+    MODE_HARD,
+    MODE_LOW_GRAVITY,
+    MODE_COUNT
+};
+
+const GameConfig *const GAME_MODE_CONFIGS[MODE_COUNT] = {&NORMAL_CONFIG, &EASY_CONFIG, &HARD_CONFIG, &LOW_GRAVITY_CONFIG};
+const char *const GAME_MODE_NAMES[MODE_COUNT] = {"NORMAL", "EASY", "HARD", "LOW GRAVITY"};
+
+inline GameParams paramsFor(GameMode mode)
+{
+    return GAME_MODE_CONFIGS[mode]->params();
+}
+
+// One screen-height slice of a level. Platform 0 sits exactly on the chunk's lower
+// edge and every platform, the next chunk's first included, is reachable from the
+// one before it. Altitudes are measured upwards from the starting platform.
+struct LevelChunk
+{
+    int index = 0;
+    int count = 0;
+    int x[CHUNK_CAPACITY] = {};
+    int altitude[CHUNK_CAPACITY] = {};
+};
+
+// Build chunk `index` of the level with the given seed. Depends on nothing else,
+// so a chunk made ahead of time on another thread equals one made on demand.
+LevelChunk generateChunk(std::uint64_t levelSeed, int index, const GameParams &params);
+
+// Whether a jump from one platform can land on another with the given params
+bool isReachable(const Platform &from, const Platform &to, const GameParams &params);
+
+// Highest platform a single jump can reach
+int maxJumpHeight(const GameParams &params);
+
+// Supplies a pre-generated chunk; returns false if it is not ready
+using ChunkSource = std::function<bool(std::uint64_t levelSeed, int index, LevelChunk &chunk)>;
+
+// Player controls sampled for a single simulation step
+struct GameInput
+{
+    bool left = false;
+    bool right = false;
+};
+
+// Bitmask form of GameInput, used by replays and the input queue
+const std::uint8_t INPUT_LEFT = 1 << 0;
+const std::uint8_t INPUT_RIGHT = 1 << 1;
+
+inline std::uint8_t inputToMask(const GameInput &input)
+{
+    return (input.left ? INPUT_LEFT : 0) | (input.right ? INPUT_RIGHT : 0);
+}
+
+inline GameInput maskToInput(std::uint8_t mask)
+{
+    GameInput input;
+    input.left = (mask & INPUT_LEFT) != 0;
+    input.right = (mask & INPUT_RIGHT) != 0;
+    return input;
+}
+
+// Every mutable part of a running game, random generator included, in one
+// trivially copyable block, so saving or rewinding a game is one flat copy
+struct SimState
+{
+    PlatformRing platforms;
+    // Player position in sub-pixel units, feet resting on the starting platform
+    float x = WINDOW_WIDTH / 2, y = WINDOW_HEIGHT - 80 - PLAYER_HEIGHT;
+    float dx = 0, dy = 0;
+    int currentScore = 0;
+    int lastPlatformY = WINDOW_HEIGHT - 80;
+    int frameCounter = 0;
+    bool gameOver = false;
+
+    // Previous tick's player position and this tick's camera scroll, used for render interpolation
+    float prevX = WINDOW_WIDTH / 2, prevY = WINDOW_HEIGHT - 80 - PLAYER_HEIGHT;
+    int lastScroll = 0;
+
+    // Highest point (smallest y) the player passed during the last step; the camera follows it,
+    // so a long step that rises and falls again still scrolls as far as single ticks would
+    float peakY = WINDOW_HEIGHT - 80 - PLAYER_HEIGHT;
+
+    // Landings so far this game and where the latest one touched down, in screen space,
+    // with whether it earned the long-jump bonus; renderers turn these into effects
+    int landings = 0;
+    float landingX = 0, landingY = 0;
+    bool landingBonus = false;
+
+    // Run statistics for tuning: total camera climb and spawned gaps the jump arc cannot clear
+    int heightClimbed = 0;
+    int gapsSpawned = 0;
+    int unreachableGaps = 0;
+
+    // Level being climbed: its seed and the chunk the next platforms come from
+    std::uint64_t levelSeed = 0;
+    LevelChunk chunk;
+    int chunkCursor = 0;
+
+    Rng rng;
+};
+
+static_assert(std::is_trivially_copyable_v<SimState>, "SimState must stay a flat copyable block");
+
+// Window-independent game logic: platforms, player physics, scoring and camera.
+// Has no SFML dependency so it can run headless on build servers.
+struct GameSim : SimState
+{
+    GameParams params;
+
+    // Optional source of chunks generated ahead of time; chunks it does not have are made on the spot
+    ChunkSource chunkSource;
+
+    explicit GameSim(std::uint64_t seed = 1, const GameParams &params = GameParams());
+
+    // Lay out a fresh set of platforms and respawn the player on the starting platform
+    void reset();
+
+    // Reseed the generator, then reset; a run is fully determined by this seed and its inputs
+    void reset(std::uint64_t seed);
+
+    // Whether a jump from one platform can land on another given the current params
+    bool isReachable(const Platform &from, const Platform &to) const { return ::isReachable(from, to, params); }
+
+    // Copy the game state out, or rewind to a copy, for rollback and lookahead search.
+    // A restored game continues exactly as the original would for the same inputs.
+    // Copied as the base class, not with memcpy of sizeof(SimState): GameSim's own
+    // members may sit in SimState's tail padding, and params must survive a restore.
+    void snapshot(SimState &out) const { out = static_cast<const SimState &>(*this); }
+    void restore(const SimState &state) { static_cast<SimState &>(*this) = state; }
+
+    // Advance the game by params.timeStep ticks of TICK_SECONDS
+    void step(const GameInput &input);
+
+    // The two halves of step(), exposed so callers can time them separately:
+    // player movement, gravity and landing, then camera scroll and platform recycling.
+    // scrollCamera() returns the pixels scrolled.
+    void movePlayer(const GameInput &input);
+    int scrollCamera();
+
+    // Change params; use this rather than assigning them, so the player update matches.
+    // Params equal to a GameConfig's get that mode's specialized update, others one
+    // that reads params every tick.
+    void setParams(const GameParams &newParams);
+
+    // Mode whose specialized update is in use, or MODE_COUNT for custom params
+    GameMode mode() const { return currentMode; }
+
+private:
+    // Move platforms from the level into the ring as they come within PLATFORM_SPAWN_MARGIN of the screen
+    void spawnPlatforms();
+
+    template <class Physics>
+    void movePlayerWith(const Physics &physics, const GameInput &input);
+    template <const GameConfig &Config>
+    void movePlayerFor(const GameInput &input);
+    void movePlayerCustom(const GameInput &input);
+
+    using MoveKernel = void (GameSim::*)(const GameInput &);
+    MoveKernel moveKernel = &GameSim::movePlayerCustom;
+    GameMode currentMode = MODE_COUNT;
+};
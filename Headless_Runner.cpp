@@ -0,0 +1,91 @@
+#include "GameSim.h"
+#include "Policies.h"
+#include "AgentBatch.h"
+#include "CollisionKernel.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    long long totalFrames = argc > 1 ? std::atoll(argv[1]) : 10000000;
+    unsigned long long seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+    int ghostCount = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    // Ticks per simulated step; longer steps trade frame detail for throughput
+    GameParams params;
+    params.timeStep = argc > 4 ? (float)std::atof(argv[4]) : 1.0f;
+    if (params.timeStep <= 0)
+    {
+        std::cerr << "Time step must be positive\n";
+        return 1;
+    }
+    if (ghostCount > 0 && params.timeStep != 1.0f)
+    {
+        std::cerr << "Ghosts only run with a time step of 1\n";
+        return 1;
+    }
+
+    GameSim sim(seed, params);
+
+    // Optional ghosts: random-input agents sharing the player's platform field
+    AgentBatch ghosts(ghostCount);
+    std::vector<RandomPolicy> ghostPolicies;
+    for (int i = 0; i < ghostCount; i++)
+    {
+        ghostPolicies.emplace_back(seed * 7919 + i);
+    }
+    std::vector<GameInput> ghostInputs(ghostCount);
+    long long gamesPlayed = 0;
+    long long scoreSum = 0;
+    int bestScore = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (long long frame = 0; frame < totalFrames; frame++)
+    {
+        if (ghostCount > 0)
+        {
+            for (int i = 0; i < ghostCount; i++)
+            {
+                ghostInputs[i] = ghostPolicies[i].next();
+            }
+            ghosts.step(sim.platforms, ghostInputs.data(), sim.params);
+        }
+
+        sim.step(scriptedPolicy(sim));
+        ghosts.scroll(sim.lastScroll);
+
+        if (sim.gameOver)
+        {
+            gamesPlayed++;
+            scoreSum += sim.currentScore;
+            if (sim.currentScore > bestScore)
+            {
+                bestScore = sim.currentScore;
+            }
+            sim.reset();
+            ghosts.reset();
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "Frames:        " << totalFrames << "\n";
+    std::cout << "Time step:     " << params.timeStep << " ticks\n";
+    std::cout << "Games played:  " << gamesPlayed << "\n";
+    std::cout << "Average score: " << (gamesPlayed > 0 ? (double)scoreSum / gamesPlayed : 0.0) << "\n";
+    std::cout << "Best score:    " << bestScore << "\n";
+    std::cout << "Elapsed:       " << seconds << " s\n";
+    std::cout << "Frames/sec:    " << (seconds > 0 ? totalFrames / seconds : 0.0) << "\n";
+    if (ghostCount > 0)
+    {
+        std::cout << "Ghosts:        " << ghostCount << " (" << collisionKernelIsa() << " collision)\n";
+        std::cout << "Agent steps/s: " << (seconds > 0 ? (double)totalFrames * ghostCount / seconds : 0.0) << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "InputQueue.h"
+
+void InputQueue::push(Clock::time_point time, std::uint8_t mask, bool pressed)
+{
+    // Drains happen in time order, so the queue stays sorted
+    events.push_back(KeyEvent{time, mask, pressed});
+}
+
+void InputQueue::releaseAll(Clock::time_point time)
+{
+    push(time, INPUT_LEFT | INPUT_RIGHT, false);
+}
+
+GameInput InputQueue::advanceTo(Clock::time_point tickEnd)
+{
+    std::uint8_t pressedInWindow = 0;
+    hasPress = false;
+
+    while (!events.empty() && events.front().time <= tickEnd)
+    {
+        const KeyEvent &event = events.front();
+        if (event.pressed)
+        {
+            if (!hasPress)
+            {
+                hasPress = true;
+                pressTime = event.time;
+            }
+            pressedInWindow |= event.mask;
+            held |= event.mask;
+        }
+        else
+        {
+            held &= ~event.mask;
+        }
+        events.pop_front();
+    }
+
+    return maskToInput(held | pressedInWindow);
+}
+
+bool InputQueue::lastPressTime(Clock::time_point &time) const
+{
+    if (hasPress)
+        time = pressTime;
+    return hasPress;
+}
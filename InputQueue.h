@@ -0,0 +1,44 @@
+#pragma once
+#include "GameSim.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+// Timestamped movement key events waiting to be applied to the simulation.
+//
+// The window drains its events whenever it can (at frame start and while the
+// frame pacer waits) and pushes key presses and releases here with the time
+// they were seen. Each simulation tick then consumes the events that arrived
+// before the end of its time window, so a key takes effect on the tick it
+// occurred instead of on whatever frame happened to sample the keyboard.
+class InputQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Record a press or release of the keys in mask (INPUT_LEFT / INPUT_RIGHT)
+    void push(Clock::time_point time, std::uint8_t mask, bool pressed);
+
+    // Release every key, e.g. when the window loses focus and will miss the release events
+    void releaseAll(Clock::time_point time);
+
+    // Apply every event up to tickEnd and return the input for the tick ending then.
+    // A key pressed and released within the window still counts for that tick.
+    GameInput advanceTo(Clock::time_point tickEnd);
+
+    // Earliest press applied by the last advanceTo, for latency measurement
+    bool lastPressTime(Clock::time_point &time) const;
+
+private:
+    struct KeyEvent
+    {
+        Clock::time_point time;
+        std::uint8_t mask;
+        bool pressed;
+    };
+
+    std::deque<KeyEvent> events;
+    std::uint8_t held = 0;
+    bool hasPress = false;
+    Clock::time_point pressTime;
+};
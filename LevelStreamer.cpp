@@ -0,0 +1,79 @@
+#include "LevelStreamer.h"
+
+LevelStreamer::LevelStreamer()
+{
+    worker = std::thread(&LevelStreamer::run, this);
+}
+
+LevelStreamer::~LevelStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void LevelStreamer::start(std::uint64_t seed, const GameParams &levelParams, int firstChunk)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.clear();
+        levelSeed = seed;
+        params = levelParams;
+        nextIndex = firstChunk;
+        generation++;
+        active = true;
+    }
+    wake.notify_one();
+}
+
+bool LevelStreamer::take(std::uint64_t seed, int index, LevelChunk &chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (lock.owns_lock() && seed == levelSeed)
+    {
+        while (!ready.empty() && ready.front().index < index)
+            ready.pop_front();
+
+        if (!ready.empty() && ready.front().index == index)
+        {
+            chunk = ready.front();
+            ready.pop_front();
+            lock.unlock();
+            wake.notify_one();
+            return true;
+        }
+    }
+    missCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void LevelStreamer::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [&]()
+                  { return stopping || (active && (int)ready.size() < LEVEL_QUEUE_CHUNKS); });
+        if (stopping)
+            return;
+
+        std::uint64_t seed = levelSeed;
+        GameParams levelParams = params;
+        int index = nextIndex;
+        std::uint32_t startedGeneration = generation;
+        lock.unlock();
+
+        LevelChunk chunk = generateChunk(seed, index, levelParams);
+
+        lock.lock();
+        // A chunk for a level that was replaced meanwhile is thrown away
+        if (generation == startedGeneration)
+        {
+            ready.push_back(chunk);
+            nextIndex++;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "GameSim.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Chunks generated ahead of the one being climbed
+const int LEVEL_QUEUE_CHUNKS = 4;
+
+// Generates upcoming level chunks on a worker thread into a bounded queue.
+//
+// The simulation takes chunks in order through source(). It only ever gets a
+// chunk that is already finished and makes one itself when the worker is
+// behind, so a tick never waits on generation. Chunks depend only on the level
+// seed and chunk index, so the game plays out the same either way and replays
+// stay valid.
+class LevelStreamer
+{
+public:
+    LevelStreamer();
+    ~LevelStreamer();
+
+    LevelStreamer(const LevelStreamer &) = delete;
+    LevelStreamer &operator=(const LevelStreamer &) = delete;
+
+    // Drop queued chunks and start generating a level from the given chunk on
+    void start(std::uint64_t levelSeed, const GameParams &params, int firstChunk);
+
+    // Pop chunk `index` of a level if it is ready; earlier chunks are discarded.
+    // Never blocks: returns false if the chunk is not ready or the queue is busy.
+    bool take(std::uint64_t levelSeed, int index, LevelChunk &chunk);
+
+    // For GameSim::chunkSource
+    ChunkSource source()
+    {
+        return [this](std::uint64_t levelSeed, int index, LevelChunk &chunk)
+        { return take(levelSeed, index, chunk); };
+    }
+
+    // Chunks that were not ready when the simulation needed them
+    int misses() const { return missCount.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<LevelChunk> ready;
+    std::uint64_t levelSeed = 0;
+    GameParams params;
+    int nextIndex = 0;
+    std::uint32_t generation = 0;
+    bool active = false;
+    bool stopping = false;
+    std::atomic<int> missCount{0};
+    std::thread worker;
+};
@@ -0,0 +1,108 @@
+#include "ParticlePool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int VERTICES_PER_PARTICLE = 6;
+
+    // Uniform float in [0, 1)
+    float unit(Rng &rng)
+    {
+        return (rng.next() >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+ParticlePool::ParticlePool()
+    : x(PARTICLE_CAPACITY), y(PARTICLE_CAPACITY), vx(PARTICLE_CAPACITY), vy(PARTICLE_CAPACITY),
+      age(PARTICLE_CAPACITY), life(PARTICLE_CAPACITY), side(PARTICLE_CAPACITY),
+      color(PARTICLE_CAPACITY), vertices(PARTICLE_CAPACITY * VERTICES_PER_PARTICLE)
+{
+    rng.seed(0x5EED);
+}
+
+void ParticlePool::emit(sf::Vector2f position, const ParticleBurst &burst)
+{
+    int emitted = std::min(burst.count, PARTICLE_CAPACITY - count);
+    for (int n = 0; n < emitted; n++)
+    {
+        int i = count++;
+        float angle = burst.angle + (2 * unit(rng) - 1) * burst.spread;
+        float speed = burst.speed * (0.5f + 0.5f * unit(rng));
+        x[i] = position.x;
+        y[i] = position.y;
+        vx[i] = std::cos(angle) * speed;
+        vy[i] = std::sin(angle) * speed;
+        age[i] = 0;
+        life[i] = burst.life * (0.5f + 0.5f * unit(rng));
+        side[i] = burst.size;
+        color[i] = burst.color;
+    }
+}
+
+void ParticlePool::update(float seconds)
+{
+    // Plain arithmetic over the packed arrays, which the compiler vectorizes
+    const float fall = PARTICLE_GRAVITY * seconds;
+    for (int i = 0; i < count; i++)
+    {
+        vy[i] += fall;
+        x[i] += vx[i] * seconds;
+        y[i] += vy[i] * seconds;
+        age[i] += seconds;
+    }
+
+    for (int i = 0; i < count;)
+    {
+        if (age[i] < life[i])
+        {
+            i++;
+            continue;
+        }
+
+        int last = --count;
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        age[i] = age[last];
+        life[i] = life[last];
+        side[i] = side[last];
+        color[i] = color[last];
+    }
+}
+
+void ParticlePool::shift(float dx, float dy)
+{
+    for (int i = 0; i < count; i++)
+    {
+        x[i] += dx;
+        y[i] += dy;
+    }
+}
+
+void ParticlePool::draw(sf::RenderTarget &target, const sf::RenderStates &states)
+{
+    if (count == 0)
+        return;
+
+    for (int i = 0; i < count; i++)
+    {
+        float half = side[i] * 0.5f;
+        sf::Color fade = color[i];
+        fade.a = (std::uint8_t)(fade.a * (1.0f - age[i] / life[i]));
+
+        float left = x[i] - half, right = x[i] + half;
+        float top = y[i] - half, bottom = y[i] + half;
+        sf::Vertex *quad = &vertices[(size_t)i * VERTICES_PER_PARTICLE];
+        quad[0].position = sf::Vector2f(left, top);
+        quad[1].position = sf::Vector2f(right, top);
+        quad[2].position = sf::Vector2f(left, bottom);
+        quad[3].position = sf::Vector2f(left, bottom);
+        quad[4].position = sf::Vector2f(right, top);
+        quad[5].position = sf::Vector2f(right, bottom);
+        for (int v = 0; v < VERTICES_PER_PARTICLE; v++)
+            quad[v].color = fade;
+    }
+    target.draw(vertices.data(), (size_t)count * VERTICES_PER_PARTICLE, sf::PrimitiveType::Triangles, states);
+}
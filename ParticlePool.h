@@ -0,0 +1,56 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "GameSim.h"
+#include <vector>
+
+// Live particles the pool holds at most; bursts past this are cut short
+const int PARTICLE_CAPACITY = 16384;
+
+// Downward pull on particles, in pixels per second squared
+const float PARTICLE_GRAVITY = 900.0f;
+
+// How a burst of particles looks and moves
+struct ParticleBurst
+{
+    int count;
+    sf::Color color;
+    float speed;  // Pixels per second, each particle gets between half and all of it
+    float angle;  // Mean direction in radians; -pi/2 is straight up
+    float spread; // Directions vary by up to this much either side
+    float life;   // Seconds, each particle gets between half and all of it
+    float size;   // Side of each square in pixels
+};
+
+// Fixed-capacity particle system for effects.
+//
+// Particles are stored structure-of-arrays with the live ones packed at the
+// front, so an update is one pass over contiguous floats and a dead particle is
+// removed by moving the last live one into its place. Nothing is allocated after
+// construction, and every live particle is drawn as a fading untextured quad in
+// a single draw call.
+class ParticlePool
+{
+public:
+    ParticlePool();
+
+    void emit(sf::Vector2f position, const ParticleBurst &burst);
+
+    // Advance every particle and drop the ones that have run out of life
+    void update(float seconds);
+
+    // Move every particle, e.g. down by the camera's scroll
+    void shift(float dx, float dy);
+
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void draw(sf::RenderTarget &target, const sf::RenderStates &states = sf::RenderStates::Default);
+
+private:
+    std::vector<float> x, y, vx, vy, age, life, side;
+    std::vector<sf::Color> color;
+    std::vector<sf::Vertex> vertices;
+    int count = 0;
+    Rng rng;
+};
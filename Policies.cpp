@@ -0,0 +1,75 @@
+#include "Policies.h"
+
+GameInput scriptedPolicy(const GameSim &sim)
+{
+    float feetY = sim.y + PLAYER_HEIGHT;
+    int targetIndex = -1;
+    float bestDistance = WINDOW_HEIGHT * 2;
+
+    for (int i = 0; i < sim.platforms.size(); i++)
+    {
+        // While rising aim for platforms above, while falling aim for the closest one below
+        float distance = sim.dy < 0 ? feetY - sim.platforms.y(i) : sim.platforms.y(i) - feetY;
+        if (distance >= 0 && distance < bestDistance)
+        {
+            bestDistance = distance;
+            targetIndex = i;
+        }
+    }
+
+    GameInput input;
+    if (targetIndex >= 0)
+    {
+        float playerCenter = sim.x + PLAYER_WIDTH / 2;
+        int platformCenter = sim.platforms.x(targetIndex) + PLATFORM_WIDTH / 2;
+        input.right = playerCenter < platformCenter - sim.params.playerSpeed;
+        input.left = playerCenter > platformCenter + sim.params.playerSpeed;
+    }
+    return input;
+}
+
+GameInput LookaheadPolicy::next(const GameSim &sim)
+{
+    SimState start;
+    sim.snapshot(start);
+    scratch.setParams(sim.params);
+
+    const GameInput candidates[3] = {maskToInput(0), maskToInput(INPUT_LEFT), maskToInput(INPUT_RIGHT)};
+    GameInput best = candidates[0];
+    long long bestValue = 0;
+    for (int c = 0; c < 3; c++)
+    {
+        scratch.restore(start);
+        int ticks = 0;
+        while (ticks < horizon && !scratch.gameOver)
+        {
+            scratch.step(candidates[c]);
+            ticks++;
+        }
+        statesExplored += ticks;
+
+        // Falling off is worst, and falling later beats falling sooner; otherwise rank by score, then altitude
+        long long value = scratch.gameOver ? ticks - horizon
+                                           : (long long)scratch.currentScore * WINDOW_HEIGHT + scratch.heightClimbed + (long long)(WINDOW_HEIGHT - scratch.y);
+        if (c == 0 || value > bestValue)
+        {
+            best = candidates[c];
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+GameInput RandomPolicy::next()
+{
+    // Re-roll the held direction every few ticks so the player actually travels somewhere
+    if (holdTicks <= 0)
+    {
+        int direction = rng.nextInt(3);
+        held.left = direction == 1;
+        held.right = direction == 2;
+        holdTicks = 4 + rng.nextInt(16);
+    }
+    holdTicks--;
+    return held;
+}
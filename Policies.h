@@ -0,0 +1,35 @@
+#pragma once
+#include "GameSim.h"
+
+// Scripted input: steer towards the platform the player is about to land on
+GameInput scriptedPolicy(const GameSim &sim);
+
+// Random input: hold a random direction for a random number of ticks
+struct RandomPolicy
+{
+    Rng rng;
+    int holdTicks = 0;
+    GameInput held;
+
+    explicit RandomPolicy(std::uint64_t seed) { rng.seed(seed); }
+
+    GameInput next();
+};
+
+// Ticks each lookahead branch is played forward: about one full jump arc
+const int LOOKAHEAD_TICKS = 40;
+
+// Lookahead search: branch the game with snapshot/restore, hold each input for a
+// short horizon and take the one that ends highest without falling
+struct LookaheadPolicy
+{
+    int horizon;
+    GameSim scratch;
+
+    // Simulated ticks across all branches, for throughput reporting
+    long long statesExplored = 0;
+
+    explicit LookaheadPolicy(int horizon = LOOKAHEAD_TICKS) : horizon(horizon) {}
+
+    GameInput next(const GameSim &sim);
+};
@@ -0,0 +1,230 @@
+#include "Replay.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    const char REPLAY_MAGIC[4] = {'D', 'J', 'R', 'P'};
+}
+
+bool saveReplay(const std::string &path, const Replay &replay)
+{
+    std::vector<std::uint8_t> bytes;
+    encodeReplay(replay, bytes);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char *)bytes.data(), (std::streamsize)bytes.size());
+    return (bool)file;
+}
+
+bool loadReplay(const std::string &path, Replay &replay, std::string &error)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        error = "cannot open file";
+        return false;
+    }
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decodeReplay(bytes.data(), bytes.size(), replay, error);
+}
+
+bool decodeReplay(const std::uint8_t *data, size_t size, Replay &replay, std::string &error)
+{
+    const std::uint8_t *end = data + size;
+    auto get = [&]() -> int
+    {
+        return data < end ? *data++ : EOF;
+    };
+    auto getVarint = [&](std::uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = get();
+            if (byte == EOF)
+                return false;
+            value |= (std::uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    };
+
+    if (size < sizeof(REPLAY_MAGIC) || !std::equal(data, data + 4, REPLAY_MAGIC))
+    {
+        error = "not a replay file";
+        return false;
+    }
+    data += sizeof(REPLAY_MAGIC);
+
+    int version = get();
+    if (version != REPLAY_VERSION)
+    {
+        error = "unsupported replay version " + std::to_string(version);
+        return false;
+    }
+
+    replay = Replay();
+    for (int i = 0; i < 8; i++)
+    {
+        int byte = get();
+        if (byte == EOF)
+        {
+            error = "truncated header";
+            return false;
+        }
+        replay.seed |= (std::uint64_t)(byte & 0xFF) << (i * 8);
+    }
+
+    int mode = get();
+    if (mode == EOF || mode >= MODE_COUNT)
+    {
+        error = mode == EOF ? "truncated header" : "unknown game mode " + std::to_string(mode);
+        return false;
+    }
+    replay.mode = (GameMode)mode;
+
+    std::uint64_t runTicks = 0;
+    while (true)
+    {
+        int mask = get();
+        if (mask == EOF)
+        {
+            error = "missing trailer";
+            return false;
+        }
+        if (mask == REPLAY_END_MARKER)
+            break;
+        if (!getVarint(runTicks))
+        {
+            error = "truncated input run";
+            return false;
+        }
+        replay.runs.push_back(InputRun{(std::uint8_t)mask, (std::uint32_t)runTicks});
+    }
+
+    std::uint64_t totalTicks = 0, finalScore = 0;
+    int gameOver = 0;
+    if (!getVarint(totalTicks) || !getVarint(finalScore) || (gameOver = get()) == EOF)
+    {
+        error = "truncated trailer";
+        return false;
+    }
+    replay.totalTicks = (std::uint32_t)totalTicks;
+    replay.finalScore = (int)finalScore;
+    replay.endedInGameOver = gameOver != 0;
+    return true;
+}
+
+void encodeReplay(const Replay &replay, std::vector<std::uint8_t> &out)
+{
+    auto putVarint = [&](std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back((std::uint8_t)((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back((std::uint8_t)value);
+    };
+
+    out.insert(out.end(), REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    out.push_back(REPLAY_VERSION);
+    for (int i = 0; i < 8; i++)
+    {
+        out.push_back((std::uint8_t)((replay.seed >> (i * 8)) & 0xFF));
+    }
+    out.push_back((std::uint8_t)replay.mode);
+    for (const InputRun &run : replay.runs)
+    {
+        out.push_back(run.mask);
+        putVarint(run.ticks);
+    }
+    out.push_back(REPLAY_END_MARKER);
+    putVarint(replay.totalTicks);
+    putVarint((std::uint64_t)replay.finalScore);
+    out.push_back(replay.endedInGameOver ? 1 : 0);
+}
+
+void appendInput(Replay &replay, const GameInput &input)
+{
+    std::uint8_t mask = inputToMask(input);
+    if (replay.runs.empty() || replay.runs.back().mask != mask)
+        replay.runs.push_back(InputRun{mask, 0});
+    replay.runs.back().ticks++;
+    replay.totalTicks++;
+}
+
+std::uint64_t replayFingerprint(const Replay &replay)
+{
+    // FNV-1a over the seed, the mode and the input runs merged to their canonical form
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](std::uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++)
+        {
+            hash ^= (value >> (8 * i)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    };
+    add(replay.seed, 8);
+    add((std::uint64_t)replay.mode, 1);
+
+    std::uint8_t mask = 0;
+    std::uint64_t ticks = 0;
+    for (const InputRun &run : replay.runs)
+    {
+        std::uint8_t used = inputToMask(maskToInput(run.mask));
+        if (run.ticks == 0 || (used == mask && ticks > 0))
+        {
+            ticks += run.ticks;
+            continue;
+        }
+        if (ticks > 0)
+        {
+            add(mask, 1);
+            add(ticks, 8);
+        }
+        mask = used;
+        ticks = run.ticks;
+    }
+    if (ticks > 0)
+    {
+        add(mask, 1);
+        add(ticks, 8);
+    }
+    return hash;
+}
+
+bool verifyReplay(const Replay &replay, int &simulatedScore)
+{
+    GameSim sim;
+    bool valid = verifyReplay(replay, sim);
+    simulatedScore = sim.currentScore;
+    return valid;
+}
+
+bool verifyReplay(const Replay &replay, GameSim &sim)
+{
+    sim.setParams(paramsFor(replay.mode));
+    sim.reset(replay.seed);
+    std::uint32_t ticks = 0;
+
+    for (const InputRun &run : replay.runs)
+    {
+        GameInput input = maskToInput(run.mask);
+        for (std::uint32_t i = 0; i < run.ticks; i++)
+        {
+            // A finished game cannot keep receiving input, and runs cannot exceed the declared length
+            if (sim.gameOver || ticks >= replay.totalTicks)
+                return false;
+            sim.step(input);
+            ticks++;
+        }
+    }
+
+    return ticks == replay.totalTicks && sim.currentScore == replay.finalScore &&
+           sim.gameOver == replay.endedInGameOver;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "GameSim.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compact binary replay: the game seed followed by the per-tick input bitmask,
+// run-length encoded. Because GameSim is fully determined by its seed and
+// inputs, replaying a file reproduces the run exactly.
+//
+// Layout (little endian):
+//   "DJRP"  magic
+//   u8      format version (REPLAY_VERSION)
+//   u64     seed
+//   u8      game mode (GameMode)
+//   runs    repeated { u8 input mask, varint tick count }
+//   u8      REPLAY_END_MARKER
+//   varint  total ticks
+//   varint  final score
+//   u8      1 if the run ended in game over, 0 if it was abandoned
+
+// Version 2: levels are generated in chunks, so version 1 runs no longer reproduce
+// Version 3: adds the game mode
+// Version 4: sub-pixel positions and swept landing change the physics
+const std::uint8_t REPLAY_VERSION = 4;
+const std::uint8_t REPLAY_END_MARKER = 0xFF;
+
+struct InputRun
+{
+    std::uint8_t mask;
+    std::uint32_t ticks;
+};
+
+struct Replay
+{
+    std::uint64_t seed = 0;
+    GameMode mode = MODE_NORMAL;
+    std::vector<InputRun> runs;
+    std::uint32_t totalTicks = 0;
+    int finalScore = 0;
+    bool endedInGameOver = false;
+};
+
+// Write a finished replay to a file. Returns false if it cannot be written.
+bool saveReplay(const std::string &path, const Replay &replay);
+
+// Parse a replay file. Returns false and fills error if the file is missing or malformed.
+bool loadReplay(const std::string &path, Replay &replay, std::string &error);
+
+// Same as loadReplay, from the file's bytes already in memory
+bool decodeReplay(const std::uint8_t *data, size_t size, Replay &replay, std::string &error);
+
+// Append a replay in the file layout, for sending it without touching the disk
+void encodeReplay(const Replay &replay, std::vector<std::uint8_t> &out);
+
+// Record one tick of input into an in-memory replay
+void appendInput(Replay &replay, const GameInput &input);
+
+// 64-bit hash of the game a replay plays: seed, mode and the input of every tick.
+// Encodings of the same inputs (runs split differently, unused mask bits) hash alike.
+std::uint64_t replayFingerprint(const Replay &replay);
+
+// Re-simulate a replay and check that it reproduces the claimed score and ending
+bool verifyReplay(const Replay &replay, int &simulatedScore);
+
+// Same, leaving sim in the run's final state for reading its height and length
+bool verifyReplay(const Replay &replay, GameSim &sim);
@@ -0,0 +1,146 @@
+#include "Replay.h"
+#include "GameScreens.h"
+#include "AssetArchive.h"
+#include "FrameCapture.h"
+#include "SimThread.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+// Offline replay renderer: re-simulates a recorded run and draws every tick through
+// the game's own screen code into an offscreen texture, then writes the frames as a
+// video or image sequence. Nothing is dropped, so the output runs at exactly TICK_RATE.
+//
+// Usage: replay_renderer [--workers=N] [--hold=SECONDS] file.djr output.y4m|output_dir
+
+int main(int argc, char **argv)
+{
+    int workers = 4;
+    double holdSeconds = 2.0;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--workers=", 10) == 0)
+            workers = std::max(1, std::atoi(argv[i] + 10));
+        else if (std::strncmp(argv[i], "--hold=", 7) == 0)
+            holdSeconds = std::max(0.0, std::atof(argv[i] + 7));
+        else
+            paths.push_back(argv[i]);
+    }
+
+    if (paths.size() != 2)
+    {
+        std::cerr << "Usage: replay_renderer [--workers=N] [--hold=SECONDS] file.djr output.y4m|output_dir\n";
+        return 1;
+    }
+
+    Replay replay;
+    std::string error;
+    if (!loadReplay(paths[0], replay, error))
+    {
+        std::cerr << "Cannot load " << paths[0] << ": " << error << "\n";
+        return 1;
+    }
+
+    AssetArchive archive;
+    if (!archive.open(ASSET_ARCHIVE_PATH, error) &&
+        !archive.openLoose(std::vector<std::string>(std::begin(GAME_ASSET_FILES), std::end(GAME_ASSET_FILES)), error))
+    {
+        std::cerr << "Cannot load assets: " << error << "\n";
+        return 1;
+    }
+
+    // The render texture owns the GL context the atlas uploads into, so it comes first
+    sf::RenderTexture target;
+    if (!target.resize(sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT)))
+    {
+        std::cerr << "Cannot create a render texture\n";
+        return 1;
+    }
+
+    TextureAtlas atlas;
+    if (!decodeAtlas(archive, atlas, error) || !atlas.upload())
+    {
+        std::cerr << "Cannot build the texture atlas: " << (error.empty() ? "upload failed" : error) << "\n";
+        return 1;
+    }
+
+    sf::Font font;
+    std::size_t fontSize = 0;
+    const std::uint8_t *fontData = archive.find(ASSET_FONT, fontSize);
+    if (!fontData || !font.openFromMemory(fontData, fontSize))
+    {
+        std::cerr << "Cannot open font " << ASSET_FONT << "\n";
+        return 1;
+    }
+
+    GameScreens screens(font, atlas);
+    screens.atlasUploaded();
+
+    const std::string &output = paths[1];
+    bool video = output.size() >= 4 && output.compare(output.size() - 4, 4, ".y4m") == 0;
+    FrameCapture capture;
+    if (!capture.open(output, video ? CaptureFormat::Y4M : CaptureFormat::PNG, sf::Vector2u(WINDOW_WIDTH, WINDOW_HEIGHT),
+                      TICK_RATE, workers, error))
+    {
+        std::cerr << "Cannot start capture: " << error << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Each tick is drawn exactly where it landed, with effects advanced by one tick
+    GameSim sim(replay.seed, paramsFor(replay.mode));
+    SimSnapshot snapshot;
+    snapshot.run = 1;
+    ScreenView view;
+    view.state = PLAYING;
+    view.snapshot = &snapshot;
+    view.alpha = 1;
+    auto renderFrame = [&]()
+    {
+        screens.updateEffects(view, (float)TICK_SECONDS);
+        screens.draw(target, view);
+        target.display();
+        capture.captureTexture(target.getTexture());
+    };
+
+    snapshot.capture(sim);
+    renderFrame();
+    for (const InputRun &run : replay.runs)
+    {
+        GameInput input = maskToInput(run.mask);
+        for (std::uint32_t i = 0; i < run.ticks && !sim.gameOver; i++)
+        {
+            sim.step(input);
+            snapshot.capture(sim);
+            renderFrame();
+        }
+    }
+
+    // A finished game stays on the game over screen for a moment, as it does in the game
+    if (sim.gameOver)
+    {
+        view.state = GAME_OVER;
+        view.bestScore = sim.currentScore;
+        for (int i = 0; i < (int)(holdSeconds * TICK_RATE); i++)
+            renderFrame();
+    }
+
+    bool written = capture.close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Rendered " << capture.captured() << " frames (" << capture.captured() * TICK_SECONDS << " s of play) to "
+              << output << " in " << seconds << " s\n";
+    if (sim.currentScore != replay.finalScore)
+        std::cerr << "Warning: the replay re-simulated to score " << sim.currentScore << ", recorded "
+                  << replay.finalScore << "\n";
+    if (!written)
+    {
+        std::cerr << "Capture incomplete: " << capture.writeError() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "Replay.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Headless replay verifier: re-simulates every replay file given on the command
+// line and checks that it reproduces the recorded score and ending.
+//
+// Usage: replay_verifier [--threads=T] [--repeat=N] file.djr [file.djr ...]
+// Exit status is 0 only if every replay verified.
+
+struct VerifyResult
+{
+    bool loaded = false;
+    bool valid = false;
+    int simulatedScore = 0;
+    std::string error;
+};
+
+int main(int argc, char **argv)
+{
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    int repeat = 1;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--threads=", 10) == 0)
+            threadCount = (unsigned int)std::max(1, std::atoi(argv[i] + 10));
+        else if (std::strncmp(argv[i], "--repeat=", 9) == 0)
+            repeat = std::max(1, std::atoi(argv[i] + 9));
+        else
+            paths.push_back(argv[i]);
+    }
+
+    if (paths.empty())
+    {
+        std::cerr << "Usage: replay_verifier [--threads=T] [--repeat=N] file.djr [file.djr ...]\n";
+        return 1;
+    }
+
+    std::vector<Replay> replays(paths.size());
+    std::vector<VerifyResult> results(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        results[i].loaded = loadReplay(paths[i], replays[i], results[i].error);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // --repeat re-runs the whole batch to measure throughput on small sets
+    ThreadPool pool(threadCount);
+    for (int pass = 0; pass < repeat; pass++)
+    {
+        pool.parallelFor((int)paths.size(), 1, [&](int begin, int end)
+                         {
+            for (int i = begin; i < end; i++)
+            {
+                if (results[i].loaded)
+                    results[i].valid = verifyReplay(replays[i], results[i].simulatedScore);
+            } });
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failures = 0;
+    long long ticks = 0;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        const VerifyResult &result = results[i];
+        if (!result.loaded)
+        {
+            std::cout << "ERROR    " << paths[i] << ": " << result.error << "\n";
+            failures++;
+            continue;
+        }
+
+        ticks += replays[i].totalTicks;
+        if (result.valid)
+        {
+            std::cout << "OK       " << paths[i] << " score " << replays[i].finalScore << "\n";
+        }
+        else
+        {
+            std::cout << "MISMATCH " << paths[i] << " claimed " << replays[i].finalScore
+                      << " simulated " << result.simulatedScore << "\n";
+            failures++;
+        }
+    }
+
+    double simulatedTicks = (double)ticks * repeat;
+    double realTimeSeconds = simulatedTicks * TICK_SECONDS;
+    std::cout << paths.size() - failures << "/" << paths.size() << " replays verified, "
+              << simulatedTicks << " ticks in " << seconds << " s ("
+              << (seconds > 0 ? realTimeSeconds / seconds : 0.0) << "x real time)\n";
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#include "ScoreClient.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+    bool sameRecords(const std::vector<ScoreRecord> &a, const std::vector<ScoreRecord> &b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const ScoreRecord &x, const ScoreRecord &y)
+                          { return x.timestamp == y.timestamp && x.score == y.score && x.height == y.height &&
+                                   x.durationMs == y.durationMs; });
+    }
+}
+
+ScoreClient::ScoreClient(const std::string &host, int port)
+    : shared(std::make_shared<Shared>())
+{
+    shared->host = host;
+    shared->port = port;
+    worker = std::thread(&ScoreClient::run, shared);
+}
+
+ScoreClient::~ScoreClient()
+{
+    bool finished = false;
+    {
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        shared->stopping = true;
+        shared->wake.notify_one();
+
+        // An exchange with a server that stopped answering can take several timeouts
+        finished = shared->stopped.wait_for(lock, std::chrono::milliseconds(SCORE_CLIENT_EXIT_WAIT_MS), [&]()
+                                            { return shared->finished; });
+    }
+    if (finished)
+        worker.join();
+    else
+        worker.detach();
+}
+
+void ScoreClient::submit(Replay run)
+{
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->pending.push_back(std::move(run));
+        if ((int)shared->pending.size() > SCORE_CLIENT_QUEUE_RUNS)
+            shared->pending.pop_front();
+    }
+    shared->wake.notify_one();
+}
+
+bool ScoreClient::takeLeaderboard(std::vector<ScoreRecord> &top)
+{
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    if (!shared->leaderboardChanged)
+        return false;
+    top = shared->leaderboard;
+    shared->leaderboardChanged = false;
+    return true;
+}
+
+bool ScoreClient::exchange(Shared &shared, SocketHandle socket, ScoreMessage replyType)
+{
+    shared.buffer.clear();
+    if (!sendAll(socket, shared.message))
+        return false;
+    shared.replySize = receiveMessage(socket, shared.buffer);
+    MessageReader reply(shared.buffer.data(), shared.replySize);
+    return shared.replySize > 0 && reply.ok() && reply.type() == replyType && reply.requestId() == shared.nextRequest - 1;
+}
+
+void ScoreClient::run(std::shared_ptr<Shared> shared)
+{
+    Shared &state = *shared;
+    SocketHandle socket = INVALID_SOCKET_HANDLE;
+    bool failed = false;
+    std::vector<Replay> batch;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (true)
+    {
+        // New runs go out straight away, unless the last attempt failed and the retry delay is running
+        state.wake.wait_for(lock, std::chrono::seconds(SCORE_CLIENT_REFRESH_SECONDS), [&]()
+                            { return state.stopping || (!failed && !state.pending.empty()); });
+        if (state.stopping)
+            break;
+
+        batch.clear();
+        while (!state.pending.empty() && (int)batch.size() < SCORE_MAX_BATCH)
+        {
+            batch.push_back(std::move(state.pending.front()));
+            state.pending.pop_front();
+        }
+        lock.unlock();
+
+        std::string error;
+        if (socket == INVALID_SOCKET_HANDLE)
+            socket = connectToServer(state.host, state.port, SCORE_CLIENT_TIMEOUT_MS, error);
+        bool ok = socket != INVALID_SOCKET_HANDLE;
+
+        std::vector<SubmitResult> results;
+        if (ok && !batch.empty())
+        {
+            state.message.clear();
+            encodeSubmit(state.message, state.nextRequest++, batch);
+            ok = exchange(state, socket, SCORE_SUBMIT_RESULT);
+            MessageReader reply(state.buffer.data(), state.replySize);
+            ok = ok && decodeSubmitResult(reply, results) && results.size() == batch.size();
+        }
+        bool sent = ok;
+
+        std::vector<ScoreRecord> top;
+        if (ok)
+        {
+            state.message.clear();
+            encodeTop(state.message, state.nextRequest++, SCORE_CLIENT_LEADERBOARD_ROWS);
+            ok = exchange(state, socket, SCORE_TOP_RESULT);
+            MessageReader reply(state.buffer.data(), state.replySize);
+            ok = ok && decodeTopResult(reply, top);
+        }
+
+        if (!ok && socket != INVALID_SOCKET_HANDLE)
+        {
+            closeSocket(socket);
+            socket = INVALID_SOCKET_HANDLE;
+        }
+        if (!ok && !failed)
+            std::cerr << "Score server " << state.host << ":" << state.port << " unavailable, retrying every "
+                      << SCORE_CLIENT_REFRESH_SECONDS << " s\n";
+        for (const SubmitResult &result : results)
+        {
+            if (!result.accepted)
+                std::cerr << "Score server rejected a run\n";
+        }
+
+        lock.lock();
+        failed = !ok;
+        if (ok && !sameRecords(top, state.leaderboard))
+        {
+            state.leaderboard = top;
+            state.leaderboardChanged = true;
+        }
+        if (!sent)
+        {
+            // Unsent runs go back in front of newer ones, within the queue limit
+            state.pending.insert(state.pending.begin(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+            while ((int)state.pending.size() > SCORE_CLIENT_QUEUE_RUNS)
+                state.pending.pop_front();
+        }
+    }
+
+    if (socket != INVALID_SOCKET_HANDLE)
+        closeSocket(socket);
+    state.finished = true;
+    state.stopped.notify_all();
+}
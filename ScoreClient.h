@@ -0,0 +1,77 @@
+#pragma once
+#include "ScoreProtocol.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs kept while the server is unreachable; the oldest are dropped beyond this
+const int SCORE_CLIENT_QUEUE_RUNS = 64;
+
+// Rows of the shared leaderboard fetched for the menu
+const int SCORE_CLIENT_LEADERBOARD_ROWS = 10;
+
+// How often the shared leaderboard is refreshed, and how long to wait after a failure
+const int SCORE_CLIENT_REFRESH_SECONDS = 10;
+
+// Connect, send and receive each give up after this long
+const int SCORE_CLIENT_TIMEOUT_MS = 3000;
+
+// How long exit waits for an exchange in progress before leaving the thread to finish it alone
+const int SCORE_CLIENT_EXIT_WAIT_MS = 250;
+
+// A game station's connection to the score server.
+//
+// submit() only queues the run; a background thread sends queued runs in one
+// batch, fetches the shared leaderboard after each exchange and every
+// SCORE_CLIENT_REFRESH_SECONDS, and reconnects as needed, so neither game over
+// nor the menu ever waits on the network. Runs still queued at exit are lost,
+// and exit waits at most SCORE_CLIENT_EXIT_WAIT_MS for an unreachable server.
+class ScoreClient
+{
+public:
+    ScoreClient(const std::string &host, int port);
+    ~ScoreClient();
+
+    ScoreClient(const ScoreClient &) = delete;
+    ScoreClient &operator=(const ScoreClient &) = delete;
+
+    // Queue a finished run for validation and ranking by the server
+    void submit(Replay run);
+
+    // The shared leaderboard, if a newer one arrived since the last call
+    bool takeLeaderboard(std::vector<ScoreRecord> &top);
+
+private:
+    // Everything the worker touches. It holds its own reference, so a worker
+    // left behind at exit never outlives the state it uses.
+    struct Shared
+    {
+        std::string host;
+        int port = 0;
+
+        // Owned by the worker thread
+        std::vector<std::uint8_t> message;
+        std::vector<std::uint8_t> buffer;
+        size_t replySize = 0;
+        std::uint32_t nextRequest = 1;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable stopped;
+        std::deque<Replay> pending;
+        std::vector<ScoreRecord> leaderboard;
+        bool leaderboardChanged = false;
+        bool stopping = false;
+        bool finished = false;
+    };
+
+    static void run(std::shared_ptr<Shared> shared);
+    static bool exchange(Shared &shared, SocketHandle socket, ScoreMessage replyType);
+
+    std::shared_ptr<Shared> shared;
+    std::thread worker;
+};
@@ -0,0 +1,406 @@
+#include "ScoreProtocol.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Ws2_32.lib")
+#endif
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+    void putU8(std::vector<std::uint8_t> &out, std::uint8_t value)
+    {
+        out.push_back(value);
+    }
+
+    void putU16(std::vector<std::uint8_t> &out, std::uint16_t value)
+    {
+        out.push_back((std::uint8_t)value);
+        out.push_back((std::uint8_t)(value >> 8));
+    }
+
+    void putU32(std::vector<std::uint8_t> &out, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.push_back((std::uint8_t)(value >> (i * 8)));
+    }
+
+    void putU64(std::vector<std::uint8_t> &out, std::uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+            out.push_back((std::uint8_t)(value >> (i * 8)));
+    }
+
+    std::uint32_t getU32(const std::uint8_t *data)
+    {
+        return (std::uint32_t)data[0] | (std::uint32_t)data[1] << 8 | (std::uint32_t)data[2] << 16 | (std::uint32_t)data[3] << 24;
+    }
+
+    // Write a message header with a placeholder size; returns where the message starts
+    size_t beginMessage(std::vector<std::uint8_t> &out, ScoreMessage type, std::uint32_t requestId)
+    {
+        size_t start = out.size();
+        putU32(out, 0);
+        putU8(out, type);
+        putU32(out, requestId);
+        return start;
+    }
+
+    void finishMessage(std::vector<std::uint8_t> &out, size_t start)
+    {
+        std::uint32_t size = (std::uint32_t)(out.size() - start - 4);
+        for (int i = 0; i < 4; i++)
+            out[start + i] = (std::uint8_t)(size >> (i * 8));
+    }
+
+#ifdef _WIN32
+    // Winsock needs starting once per process
+    struct WinsockSession
+    {
+        WinsockSession()
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+        ~WinsockSession() { WSACleanup(); }
+    };
+
+    void setBlocking(SocketHandle socket, bool blocking)
+    {
+        u_long nonBlocking = blocking ? 0 : 1;
+        ioctlsocket((SOCKET)socket, FIONBIO, &nonBlocking);
+    }
+
+    int pollSockets(pollfd *fds, int count, int timeoutMs)
+    {
+        return WSAPoll(fds, (ULONG)count, timeoutMs);
+    }
+
+    void setTimeouts(SocketHandle socket, int timeoutMs)
+    {
+        DWORD timeout = (DWORD)timeoutMs;
+        setsockopt((SOCKET)socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+        setsockopt((SOCKET)socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+    }
+#else
+    void setBlocking(SocketHandle socket, bool blocking)
+    {
+        int flags = fcntl((int)socket, F_GETFL, 0);
+        fcntl((int)socket, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+    }
+
+    int pollSockets(pollfd *fds, int count, int timeoutMs)
+    {
+        return poll(fds, (nfds_t)count, timeoutMs);
+    }
+
+    void setTimeouts(SocketHandle socket, int timeoutMs)
+    {
+        timeval timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        setsockopt((int)socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt((int)socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+#endif
+}
+
+MessageReader::MessageReader(const std::uint8_t *data, size_t size)
+    : cursor(data), end(data + size)
+{
+    std::uint32_t bodySize = 0;
+    std::uint8_t type = 0;
+    valid = readU32(bodySize) && bodySize == size - 4 && readU8(type) && readU32(id);
+    messageType = (ScoreMessage)type;
+}
+
+bool MessageReader::readU8(std::uint8_t &value)
+{
+    if (end - cursor < 1)
+        return valid = false;
+    value = *cursor++;
+    return true;
+}
+
+bool MessageReader::readU16(std::uint16_t &value)
+{
+    if (end - cursor < 2)
+        return valid = false;
+    value = (std::uint16_t)(cursor[0] | cursor[1] << 8);
+    cursor += 2;
+    return true;
+}
+
+bool MessageReader::readU32(std::uint32_t &value)
+{
+    if (end - cursor < 4)
+        return valid = false;
+    value = getU32(cursor);
+    cursor += 4;
+    return true;
+}
+
+bool MessageReader::readU64(std::uint64_t &value)
+{
+    std::uint32_t low = 0, high = 0;
+    if (!readU32(low) || !readU32(high))
+        return false;
+    value = (std::uint64_t)high << 32 | low;
+    return true;
+}
+
+bool MessageReader::readBytes(size_t size, const std::uint8_t *&bytes)
+{
+    if ((size_t)(end - cursor) < size)
+        return valid = false;
+    bytes = cursor;
+    cursor += size;
+    return true;
+}
+
+long long completeMessageSize(const std::uint8_t *data, size_t size)
+{
+    if (size < 4)
+        return 0;
+    std::uint32_t bodySize = getU32(data);
+    if (bodySize > SCORE_MAX_MESSAGE_BYTES)
+        return -1;
+    return size >= (size_t)bodySize + 4 ? (long long)bodySize + 4 : 0;
+}
+
+void encodeSubmit(std::vector<std::uint8_t> &out, std::uint32_t requestId, const std::vector<Replay> &replays)
+{
+    size_t start = beginMessage(out, SCORE_SUBMIT, requestId);
+    putU16(out, (std::uint16_t)replays.size());
+    for (const Replay &replay : replays)
+    {
+        size_t sizeAt = out.size();
+        putU32(out, 0);
+        encodeReplay(replay, out);
+        std::uint32_t size = (std::uint32_t)(out.size() - sizeAt - 4);
+        for (int i = 0; i < 4; i++)
+            out[sizeAt + i] = (std::uint8_t)(size >> (i * 8));
+    }
+    finishMessage(out, start);
+}
+
+void encodeSubmitResult(std::vector<std::uint8_t> &out, std::uint32_t requestId, const std::vector<SubmitResult> &results)
+{
+    size_t start = beginMessage(out, SCORE_SUBMIT_RESULT, requestId);
+    putU16(out, (std::uint16_t)results.size());
+    for (const SubmitResult &result : results)
+    {
+        putU8(out, result.accepted ? 1 : 0);
+        putU32(out, (std::uint32_t)result.rank);
+        putU32(out, (std::uint32_t)result.score);
+    }
+    finishMessage(out, start);
+}
+
+void encodeTop(std::vector<std::uint8_t> &out, std::uint32_t requestId, int rows)
+{
+    size_t start = beginMessage(out, SCORE_TOP, requestId);
+    putU16(out, (std::uint16_t)rows);
+    finishMessage(out, start);
+}
+
+void encodeTopResult(std::vector<std::uint8_t> &out, std::uint32_t requestId, const std::vector<ScoreRecord> &top, int rows)
+{
+    size_t start = beginMessage(out, SCORE_TOP_RESULT, requestId);
+    int count = std::min(rows, (int)top.size());
+    putU16(out, (std::uint16_t)count);
+    for (int i = 0; i < count; i++)
+    {
+        putU64(out, (std::uint64_t)top[i].timestamp);
+        putU32(out, (std::uint32_t)top[i].score);
+        putU32(out, (std::uint32_t)top[i].height);
+        putU32(out, (std::uint32_t)top[i].durationMs);
+    }
+    finishMessage(out, start);
+}
+
+bool decodeSubmit(MessageReader &message, std::vector<Replay> &replays, std::string &error)
+{
+    std::uint16_t count = 0;
+    if (!message.readU16(count) || count > SCORE_MAX_BATCH)
+    {
+        error = message.ok() ? "batch too large" : "truncated message";
+        return false;
+    }
+
+    replays.resize(count);
+    for (Replay &replay : replays)
+    {
+        std::uint32_t size = 0;
+        const std::uint8_t *bytes = nullptr;
+        if (!message.readU32(size) || !message.readBytes(size, bytes))
+        {
+            error = "truncated message";
+            return false;
+        }
+        if (!decodeReplay(bytes, size, replay, error))
+            return false;
+    }
+    return true;
+}
+
+bool decodeSubmitResult(MessageReader &message, std::vector<SubmitResult> &results)
+{
+    std::uint16_t count = 0;
+    if (!message.readU16(count))
+        return false;
+
+    results.resize(count);
+    for (SubmitResult &result : results)
+    {
+        std::uint8_t accepted = 0;
+        std::uint32_t rank = 0, score = 0;
+        if (!message.readU8(accepted) || !message.readU32(rank) || !message.readU32(score))
+            return false;
+        result.accepted = accepted != 0;
+        result.rank = (int)rank;
+        result.score = (int)score;
+    }
+    return true;
+}
+
+bool decodeTop(MessageReader &message, int &rows)
+{
+    std::uint16_t value = 0;
+    if (!message.readU16(value))
+        return false;
+    rows = value;
+    return true;
+}
+
+bool decodeTopResult(MessageReader &message, std::vector<ScoreRecord> &top)
+{
+    std::uint16_t count = 0;
+    if (!message.readU16(count))
+        return false;
+
+    top.resize(count);
+    for (ScoreRecord &record : top)
+    {
+        std::uint64_t timestamp = 0;
+        std::uint32_t score = 0, height = 0, duration = 0;
+        if (!message.readU64(timestamp) || !message.readU32(score) || !message.readU32(height) || !message.readU32(duration))
+            return false;
+        record.timestamp = (std::int64_t)timestamp;
+        record.score = (int)score;
+        record.height = (int)height;
+        record.durationMs = (int)duration;
+    }
+    return true;
+}
+
+SocketHandle connectToServer(const std::string &host, int port, int timeoutMs, std::string &error)
+{
+#ifdef _WIN32
+    static WinsockSession winsock;
+#endif
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+    {
+        error = "cannot resolve " + host;
+        return INVALID_SOCKET_HANDLE;
+    }
+
+    // Connect without blocking so an unreachable server fails within the timeout
+    SocketHandle connected = INVALID_SOCKET_HANDLE;
+    for (addrinfo *address = addresses; address && connected == INVALID_SOCKET_HANDLE; address = address->ai_next)
+    {
+        SocketHandle candidate = (SocketHandle)socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (candidate == INVALID_SOCKET_HANDLE)
+            continue;
+
+        setBlocking(candidate, false);
+        connect(candidate, address->ai_addr, (int)address->ai_addrlen);
+        pollfd writable = {};
+        writable.fd = candidate;
+        writable.events = POLLOUT;
+        int failure = 1;
+        socklen_t length = sizeof(failure);
+        if (pollSockets(&writable, 1, timeoutMs) == 1 &&
+            getsockopt(candidate, SOL_SOCKET, SO_ERROR, (char *)&failure, &length) == 0 && failure == 0)
+        {
+            connected = candidate;
+        }
+        else
+        {
+            closeSocket(candidate);
+        }
+    }
+    freeaddrinfo(addresses);
+
+    if (connected == INVALID_SOCKET_HANDLE)
+    {
+        error = "cannot connect to " + host + ":" + std::to_string(port);
+        return INVALID_SOCKET_HANDLE;
+    }
+
+    // Requests are small and answered one at a time, so they go out without batching delay
+    setBlocking(connected, true);
+    setTimeouts(connected, timeoutMs);
+    int noDelay = 1;
+    setsockopt(connected, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay, sizeof(noDelay));
+    return connected;
+}
+
+void closeSocket(SocketHandle socket)
+{
+#ifdef _WIN32
+    closesocket((SOCKET)socket);
+#else
+    close((int)socket);
+#endif
+}
+
+bool sendAll(SocketHandle socket, const std::vector<std::uint8_t> &bytes)
+{
+    size_t sent = 0;
+    while (sent < bytes.size())
+    {
+        int chunk = (int)std::min<size_t>(bytes.size() - sent, 1 << 20);
+        int written = (int)send(socket, (const char *)bytes.data() + sent, chunk, MSG_NOSIGNAL);
+        if (written <= 0)
+            return false;
+        sent += (size_t)written;
+    }
+    return true;
+}
+
+size_t receiveMessage(SocketHandle socket, std::vector<std::uint8_t> &buffer)
+{
+    char chunk[16384];
+    while (true)
+    {
+        long long size = completeMessageSize(buffer.data(), buffer.size());
+        if (size != 0)
+            return size > 0 ? (size_t)size : 0;
+
+        int received = (int)recv(socket, chunk, sizeof(chunk), 0);
+        if (received <= 0)
+            return 0;
+        buffer.insert(buffer.end(), chunk, chunk + received);
+    }
+}
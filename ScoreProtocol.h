@@ -0,0 +1,101 @@
+#pragma once
+#include "Replay.h"
+#include "ScoreStore.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Wire format between game stations and the score server.
+//
+// Every message is a little-endian u32 byte count followed by that many bytes:
+//   u8   message type (ScoreMessage)
+//   u32  request id, echoed in the reply so clients can pipeline requests
+//   ...  body
+//
+// SCORE_SUBMIT         u16 count, then count x { u32 size, replay in the .djr layout }
+// SCORE_SUBMIT_RESULT  u16 count, then count x { u8 accepted, u32 rank (0 if unranked), i32 score }
+// SCORE_TOP            u16 rows wanted
+// SCORE_TOP_RESULT     u16 count, then count x { i64 timestamp, i32 score, i32 height, i32 duration ms }
+
+const int SCORE_SERVER_PORT = 7979;
+
+// Largest message either side accepts; a peer sending more is disconnected
+const std::uint32_t SCORE_MAX_MESSAGE_BYTES = 1 << 20;
+
+// Runs one submission may carry
+const int SCORE_MAX_BATCH = 256;
+
+// Longest run the server re-simulates, one hour of play
+const std::uint32_t SCORE_MAX_REPLAY_TICKS = 60 * 60 * TICK_RATE;
+
+enum ScoreMessage : std::uint8_t
+{
+    SCORE_SUBMIT = 1,
+    SCORE_SUBMIT_RESULT = 2,
+    SCORE_TOP = 3,
+    SCORE_TOP_RESULT = 4
+};
+
+struct SubmitResult
+{
+    bool accepted = false;
+    int rank = 0;
+    int score = 0;
+};
+
+// Header fields of a received message, with a cursor over its body
+class MessageReader
+{
+public:
+    // data points at one whole message, including its size prefix
+    MessageReader(const std::uint8_t *data, size_t size);
+
+    ScoreMessage type() const { return messageType; }
+    std::uint32_t requestId() const { return id; }
+
+    bool readU8(std::uint8_t &value);
+    bool readU16(std::uint16_t &value);
+    bool readU32(std::uint32_t &value);
+    bool readU64(std::uint64_t &value);
+
+    // Borrow the next size bytes of the body
+    bool readBytes(size_t size, const std::uint8_t *&bytes);
+
+    // Whether the header was complete and no read ran past the end
+    bool ok() const { return valid; }
+
+private:
+    const std::uint8_t *cursor;
+    const std::uint8_t *end;
+    ScoreMessage messageType = SCORE_SUBMIT;
+    std::uint32_t id = 0;
+    bool valid = true;
+};
+
+// Size of the whole message at the front of a receive buffer: 0 if it has not fully
+// arrived yet, or -1 if its size prefix is over SCORE_MAX_MESSAGE_BYTES
+long long completeMessageSize(const std::uint8_t *data, size_t size);
+
+// Append one message to out
+void encodeSubmit(std::vector<std::uint8_t> &out, std::uint32_t requestId, const std::vector<Replay> &replays);
+void encodeSubmitResult(std::vector<std::uint8_t> &out, std::uint32_t requestId, const std::vector<SubmitResult> &results);
+void encodeTop(std::vector<std::uint8_t> &out, std::uint32_t requestId, int rows);
+void encodeTopResult(std::vector<std::uint8_t> &out, std::uint32_t requestId, const std::vector<ScoreRecord> &top, int rows);
+
+// Parse the body of a message whose type was already checked. Return false and fill error if malformed.
+bool decodeSubmit(MessageReader &message, std::vector<Replay> &replays, std::string &error);
+bool decodeSubmitResult(MessageReader &message, std::vector<SubmitResult> &results);
+bool decodeTop(MessageReader &message, int &rows);
+bool decodeTopResult(MessageReader &message, std::vector<ScoreRecord> &top);
+
+// Blocking TCP connection for clients, on Winsock or BSD sockets
+using SocketHandle = std::intptr_t;
+const SocketHandle INVALID_SOCKET_HANDLE = -1;
+
+// Connect within timeoutMs; sends and receives then time out after the same interval
+SocketHandle connectToServer(const std::string &host, int port, int timeoutMs, std::string &error);
+void closeSocket(SocketHandle socket);
+bool sendAll(SocketHandle socket, const std::vector<std::uint8_t> &bytes);
+
+// Receive until one whole message is at the front of buffer; returns its size, or 0 on error
+size_t receiveMessage(SocketHandle socket, std::vector<std::uint8_t> &buffer);
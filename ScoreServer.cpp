@@ -0,0 +1,430 @@
+#include "ScoreServer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    // epoll tags for the two sockets that are not connections
+    const std::uint64_t LISTEN_EVENT = 0;
+    const std::uint64_t WAKE_EVENT = ~0ULL;
+
+    const int MAX_EVENTS = 256;
+
+    // Throughput is printed this often while submissions arrive
+    const int REPORT_SECONDS = 10;
+
+    bool addToEpoll(int epollFd, int fd, std::uint64_t tag)
+    {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = tag;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+}
+
+ScoreServer::ScoreServer(unsigned int validationThreads)
+    : pool(validationThreads)
+{
+}
+
+ScoreServer::~ScoreServer()
+{
+    // Validations still running hand their results to this object
+    pool.wait();
+    for (auto &entry : connections)
+        close(entry.second.fd);
+    for (int fd : {listenFd, epollFd, wakeFd})
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+bool ScoreServer::open(int port, const std::string &logPath, std::string &error)
+{
+    store.open(logPath, "");
+    for (const ScoreRecord &record : store.top())
+    {
+        if (record.replay != 0)
+            acceptedReplays.insert(record.replay);
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((std::uint16_t)port);
+    if (listenFd < 0 || bind(listenFd, (const sockaddr *)&address, sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0)
+    {
+        error = "cannot listen on port " + std::to_string(port) + ": " + std::strerror(errno);
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0 || !addToEpoll(epollFd, listenFd, LISTEN_EVENT) || !addToEpoll(epollFd, wakeFd, WAKE_EVENT))
+    {
+        error = std::string("cannot set up epoll: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void ScoreServer::stop()
+{
+    stopping.store(true);
+    std::uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0)
+    {
+        // The counter is already non-zero, so the loop wakes anyway
+    }
+}
+
+void ScoreServer::run()
+{
+    epoll_event events[MAX_EVENTS];
+    auto lastReport = std::chrono::steady_clock::now();
+    long long reportedRuns = 0;
+
+    while (!stopping.load())
+    {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, 1000);
+        if (count < 0 && errno != EINTR)
+        {
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << "\n";
+            return;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            std::uint64_t tag = events[i].data.u64;
+            if (tag == LISTEN_EVENT)
+            {
+                acceptConnections();
+                continue;
+            }
+            if (tag == WAKE_EVENT)
+            {
+                std::uint64_t wakes = 0;
+                if (read(wakeFd, &wakes, sizeof(wakes)) < 0 && errno != EAGAIN)
+                    std::cerr << "eventfd read failed: " << std::strerror(errno) << "\n";
+                finishValidations();
+                continue;
+            }
+
+            auto found = connections.find(tag);
+            if (found == connections.end())
+                continue;
+            Connection &connection = found->second;
+            std::uint32_t ready = events[i].events;
+
+            // Hang-ups are reported even while reading is paused, so close now rather than spin on them
+            if ((ready & (EPOLLHUP | EPOLLERR)) || ((ready & EPOLLOUT) && !flush(connection)))
+            {
+                disconnect(tag);
+                continue;
+            }
+            if (ready & EPOLLIN)
+            {
+                if (!readFrom(tag, connection))
+                    continue;
+            }
+            updateInterest(tag, connection);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(REPORT_SECONDS))
+        {
+            long long runs = accepted + rejected;
+            if (runs != reportedRuns)
+            {
+                double seconds = std::chrono::duration<double>(now - lastReport).count();
+                std::cout << runs - reportedRuns << " runs in the last " << (int)seconds << " s ("
+                          << (long long)((runs - reportedRuns) / seconds) << "/s), " << accepted << " accepted and "
+                          << rejected << " rejected in total, best " << store.best() << "\n";
+            }
+            reportedRuns = runs;
+            lastReport = now;
+        }
+    }
+}
+
+void ScoreServer::acceptConnections()
+{
+    while (true)
+    {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            // Out of descriptors leaves the rest queued until a connection closes
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                std::cerr << "accept failed: " << std::strerror(errno) << "\n";
+            return;
+        }
+
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        std::uint64_t id = nextConnection++;
+        if (!addToEpoll(epollFd, fd, id))
+        {
+            close(fd);
+            continue;
+        }
+        Connection &connection = connections[id];
+        connection.fd = fd;
+        connection.interest = EPOLLIN;
+    }
+}
+
+bool ScoreServer::readFrom(std::uint64_t id, Connection &connection)
+{
+    std::uint8_t chunk[65536];
+    while (!connection.readPaused)
+    {
+        ssize_t received = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (received > 0)
+        {
+            connection.input.insert(connection.input.end(), chunk, chunk + received);
+            if (!processInput(id, connection))
+                return false;
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        if (received < 0 && errno == EINTR)
+            continue;
+
+        // Closed by the peer or failed; unanswered submissions are still ranked
+        disconnect(id);
+        return false;
+    }
+    return true;
+}
+
+bool ScoreServer::processInput(std::uint64_t id, Connection &connection)
+{
+    size_t offset = 0;
+    bool alive = true;
+    while (alive && connection.inflight < SCORE_MAX_INFLIGHT_BATCHES)
+    {
+        long long size = completeMessageSize(connection.input.data() + offset, connection.input.size() - offset);
+        if (size == 0)
+            break;
+        alive = size > 0 && handleMessage(id, connection, connection.input.data() + offset, (size_t)size);
+        offset += (size_t)std::max(size, 0LL);
+    }
+    if (!alive)
+    {
+        disconnect(id);
+        return false;
+    }
+
+    connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    connection.readPaused = connection.inflight >= SCORE_MAX_INFLIGHT_BATCHES ||
+                            connection.output.size() - connection.outputSent >= SCORE_MAX_PENDING_OUTPUT;
+    return true;
+}
+
+bool ScoreServer::handleMessage(std::uint64_t id, Connection &connection, const std::uint8_t *data, size_t size)
+{
+    MessageReader message(data, size);
+    if (!message.ok())
+        return false;
+
+    if (message.type() == SCORE_TOP)
+    {
+        int rows = 0;
+        if (!decodeTop(message, rows))
+            return false;
+        encodeTopResult(connection.output, message.requestId(), store.top(), rows);
+        return flush(connection);
+    }
+    if (message.type() != SCORE_SUBMIT)
+        return false;
+
+    auto validation = std::make_shared<Validation>();
+    validation->connection = id;
+    validation->requestId = message.requestId();
+    std::string error;
+    if (!decodeSubmit(message, validation->replays, error))
+    {
+        // A batch that cannot be read is rejected whole; the connection stays usable
+        rejected += (long long)validation->replays.size();
+        encodeSubmitResult(connection.output, message.requestId(), std::vector<SubmitResult>(validation->replays.size()));
+        return flush(connection);
+    }
+
+    int runs = (int)validation->replays.size();
+    validation->results.resize(runs);
+    validation->records.resize(runs);
+    int chunks = (runs + SCORE_VALIDATE_GRAIN - 1) / SCORE_VALIDATE_GRAIN;
+    if (chunks == 0)
+    {
+        encodeSubmitResult(connection.output, message.requestId(), validation->results);
+        return flush(connection);
+    }
+
+    connection.inflight++;
+    validation->chunksLeft = chunks;
+    for (int begin = 0; begin < runs; begin += SCORE_VALIDATE_GRAIN)
+    {
+        int end = std::min(begin + SCORE_VALIDATE_GRAIN, runs);
+        pool.submit([this, validation, begin, end]()
+                    {
+            validate(*validation, begin, end);
+            if (validation->chunksLeft.fetch_sub(1) != 1)
+                return;
+
+            bool wake = false;
+            {
+                std::lock_guard<std::mutex> lock(finishedMutex);
+                wake = finished.empty();
+                finished.push_back(validation);
+            }
+            std::uint64_t one = 1;
+            if (wake && write(wakeFd, &one, sizeof(one)) < 0)
+            {
+                // The counter is already non-zero, so the I/O thread wakes anyway
+            } });
+    }
+    return true;
+}
+
+void ScoreServer::validate(Validation &validation, int begin, int end)
+{
+    GameSim sim;
+    for (int i = begin; i < end; i++)
+    {
+        const Replay &replay = validation.replays[i];
+
+        // Only finished normal-mode runs rank, and the length cap bounds the work a run can ask for
+        bool valid = replay.mode == MODE_NORMAL && replay.endedInGameOver &&
+                     replay.totalTicks <= SCORE_MAX_REPLAY_TICKS && verifyReplay(replay, sim);
+
+        SubmitResult &result = validation.results[i];
+        result.accepted = valid;
+        result.score = valid ? sim.currentScore : 0;
+
+        ScoreRecord &record = validation.records[i];
+        record.score = sim.currentScore;
+        record.height = sim.heightClimbed;
+        record.durationMs = (int)(sim.frameCounter * TICK_SECONDS * 1000);
+        record.replay = replayFingerprint(replay);
+    }
+}
+
+void ScoreServer::finishValidations()
+{
+    std::vector<std::shared_ptr<Validation>> done;
+    {
+        std::lock_guard<std::mutex> lock(finishedMutex);
+        done.swap(finished);
+    }
+
+    std::int64_t now = (std::int64_t)std::time(nullptr);
+    for (const std::shared_ptr<Validation> &validation : done)
+    {
+        for (size_t i = 0; i < validation->results.size(); i++)
+        {
+            // Runs are checked for repeats here, on the one thread that ranks them,
+            // so the same replay in two batches at once is still accepted only once
+            SubmitResult &result = validation->results[i];
+            ScoreRecord &record = validation->records[i];
+            if (result.accepted && !acceptedReplays.insert(record.replay).second)
+                result = SubmitResult();
+            if (!result.accepted)
+            {
+                rejected++;
+                continue;
+            }
+            record.timestamp = now;
+            result.rank = store.submit(record);
+            accepted++;
+        }
+
+        auto found = connections.find(validation->connection);
+        if (found == connections.end())
+            continue;
+        Connection &connection = found->second;
+        connection.inflight--;
+        encodeSubmitResult(connection.output, validation->requestId, validation->results);
+        if (!flush(connection))
+        {
+            disconnect(validation->connection);
+            continue;
+        }
+
+        // Requests held back while the connection was at its limit
+        if (processInput(validation->connection, connection))
+            updateInterest(validation->connection, connection);
+    }
+}
+
+bool ScoreServer::flush(Connection &connection)
+{
+    while (connection.outputSent < connection.output.size())
+    {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.outputSent,
+                            connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent > 0)
+            connection.outputSent += (size_t)sent;
+        else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else if (sent < 0 && errno == EINTR)
+            continue;
+        else
+            return false;
+    }
+
+    if (connection.outputSent == connection.output.size())
+    {
+        connection.output.clear();
+        connection.outputSent = 0;
+    }
+    else if (connection.outputSent > connection.output.size() / 2)
+    {
+        connection.output.erase(connection.output.begin(), connection.output.begin() + connection.outputSent);
+        connection.outputSent = 0;
+    }
+    return true;
+}
+
+void ScoreServer::updateInterest(std::uint64_t id, Connection &connection)
+{
+    // Reading pauses while the peer is at its validation limit or not taking its replies
+    bool pendingOutput = connection.outputSent < connection.output.size();
+    connection.readPaused = connection.inflight >= SCORE_MAX_INFLIGHT_BATCHES ||
+                            connection.output.size() - connection.outputSent >= SCORE_MAX_PENDING_OUTPUT;
+
+    std::uint32_t interest = (connection.readPaused ? 0u : (std::uint32_t)EPOLLIN) | (pendingOutput ? (std::uint32_t)EPOLLOUT : 0u);
+    if (interest == connection.interest)
+        return;
+
+    epoll_event event = {};
+    event.events = interest;
+    event.data.u64 = id;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.interest = interest;
+}
+
+void ScoreServer::disconnect(std::uint64_t id)
+{
+    auto found = connections.find(id);
+    if (found == connections.end())
+        return;
+    close(found->second.fd);
+    connections.erase(found);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "ScoreProtocol.h"
+#include "ScoreStore.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Submissions a connection may have in validation before the server stops reading from it
+const int SCORE_MAX_INFLIGHT_BATCHES = 8;
+
+// Replies a connection may have unsent before the server stops reading from it
+const size_t SCORE_MAX_PENDING_OUTPUT = 1 << 20;
+
+// Runs re-simulated per pool task, so one large batch still spreads across cores
+const int SCORE_VALIDATE_GRAIN = 8;
+
+// Shared leaderboard server for game stations (Linux, epoll).
+//
+// One thread owns every socket and the leaderboard: it accepts connections,
+// reads requests and answers top-N queries straight from the in-memory
+// ScoreStore, whose own writer thread appends each accepted run to the log.
+// A submitted batch is re-simulated on a thread pool in chunks, and the last
+// chunk to finish hands the batch back through an eventfd; the I/O thread then
+// ranks the accepted runs and replies. A run is accepted only if its inputs
+// reproduce its claimed score and ending in normal mode, and only once: the
+// fingerprint of every accepted replay is remembered, for the server's lifetime
+// and through the log for the runs on the leaderboard, and repeats are rejected.
+class ScoreServer
+{
+public:
+    explicit ScoreServer(unsigned int validationThreads);
+    ~ScoreServer();
+
+    ScoreServer(const ScoreServer &) = delete;
+    ScoreServer &operator=(const ScoreServer &) = delete;
+
+    // Load the leaderboard and start listening on every interface
+    bool open(int port, const std::string &logPath, std::string &error);
+
+    // Serve until stop() is called
+    void run();
+
+    // Safe to call from a signal handler or any thread
+    void stop();
+
+    long long acceptedRuns() const { return accepted; }
+    long long rejectedRuns() const { return rejected; }
+
+private:
+    struct Connection
+    {
+        int fd = -1;
+        std::vector<std::uint8_t> input;
+        std::vector<std::uint8_t> output;
+        size_t outputSent = 0;
+        int inflight = 0;
+        bool readPaused = false;
+        std::uint32_t interest = 0; // epoll events currently registered
+    };
+
+    // A submission being validated; results are filled in by the pool
+    struct Validation
+    {
+        std::uint64_t connection;
+        std::uint32_t requestId;
+        std::vector<Replay> replays;
+        std::vector<SubmitResult> results;
+        std::vector<ScoreRecord> records;
+        std::atomic<int> chunksLeft{0};
+    };
+
+    void acceptConnections();
+    bool readFrom(std::uint64_t id, Connection &connection);
+    bool processInput(std::uint64_t id, Connection &connection);
+    bool handleMessage(std::uint64_t id, Connection &connection, const std::uint8_t *data, size_t size);
+    void validate(Validation &validation, int begin, int end);
+    void finishValidations();
+    bool flush(Connection &connection);
+    void updateInterest(std::uint64_t id, Connection &connection);
+    void disconnect(std::uint64_t id);
+
+    ThreadPool pool;
+    ScoreStore store;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::atomic<bool> stopping{false};
+
+    // Connections by id; ids are never reused, so late results for a closed one are dropped
+    std::unordered_map<std::uint64_t, Connection> connections;
+    std::uint64_t nextConnection = 1;
+
+    // Finished validations waiting for the I/O thread
+    std::mutex finishedMutex;
+    std::vector<std::shared_ptr<Validation>> finished;
+
+    // replayFingerprint of every run accepted so far
+    std::unordered_set<std::uint64_t> acceptedReplays;
+
+    long long accepted = 0;
+    long long rejected = 0;
+};
@@ -0,0 +1,280 @@
+#include "ScoreStore.h"
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // FNV-1a over the record fields, so torn or edited lines are rejected on load
+    std::uint32_t checksum(const std::string &text)
+    {
+        std::uint32_t hash = 2166136261u;
+        for (unsigned char c : text)
+        {
+            hash ^= c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    std::string recordLine(const ScoreRecord &record)
+    {
+        std::ostringstream fields;
+        fields << record.timestamp << " " << record.score << " " << record.height << " " << record.durationMs;
+        if (record.replay != 0)
+            fields << " " << std::hex << record.replay;
+        std::ostringstream line;
+        line << fields.str() << " " << std::hex << checksum(fields.str()) << "\n";
+        return line.str();
+    }
+
+    bool parseLine(const std::string &line, ScoreRecord &record)
+    {
+        size_t split = line.rfind(' ');
+        if (split == std::string::npos)
+            return false;
+
+        std::string fields = line.substr(0, split);
+        std::uint32_t stored = 0;
+        std::istringstream checksumStream(line.substr(split + 1));
+        if (!(checksumStream >> std::hex >> stored) || stored != checksum(fields))
+            return false;
+
+        // The replay fingerprint is optional; local logs and older server logs do not have it
+        std::istringstream fieldStream(fields);
+        if (!(fieldStream >> record.timestamp >> record.score >> record.height >> record.durationMs))
+            return false;
+        record.replay = 0;
+        return fieldStream.eof() || (bool)(fieldStream >> std::hex >> record.replay);
+    }
+
+    // Highest score first; ties go to the earlier run
+    bool ranksAbove(const ScoreRecord &a, const ScoreRecord &b)
+    {
+        if (a.score != b.score)
+            return a.score > b.score;
+        return a.timestamp < b.timestamp;
+    }
+
+    // Insert into a ranked list capped at SCORE_STORE_CAPACITY. Returns the 1-based rank, or 0 if it did not place.
+    int insertRanked(std::vector<ScoreRecord> &ranked, const ScoreRecord &record)
+    {
+        size_t position = 0;
+        while (position < ranked.size() && !ranksAbove(record, ranked[position]))
+            position++;
+        if (position >= (size_t)SCORE_STORE_CAPACITY)
+            return 0;
+
+        ranked.insert(ranked.begin() + position, record);
+        if (ranked.size() > (size_t)SCORE_STORE_CAPACITY)
+            ranked.pop_back();
+        return (int)position + 1;
+    }
+
+    // Write lines and make sure they reached the disk before returning
+    bool writeLines(const std::string &path, const char *mode, const std::vector<ScoreRecord> &records)
+    {
+        FILE *file = std::fopen(path.c_str(), mode);
+        if (!file)
+            return false;
+
+        bool ok = true;
+        for (const ScoreRecord &record : records)
+        {
+            std::string line = recordLine(record);
+            ok = ok && std::fwrite(line.data(), 1, line.size(), file) == line.size();
+        }
+        ok = ok && std::fflush(file) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(file)) == 0;
+#else
+        ok = ok && fsync(fileno(file)) == 0;
+#endif
+        return std::fclose(file) == 0 && ok;
+    }
+
+    // Make a rename inside the file's directory durable. Windows has no directory
+    // handle to flush; its rename is as durable as the file system makes it.
+    bool syncDirectoryOf(const std::string &path)
+    {
+#ifdef _WIN32
+        (void)path;
+        return true;
+#else
+        std::filesystem::path directory = std::filesystem::path(path).parent_path();
+        int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0)
+            return false;
+        bool ok = fsync(fd) == 0;
+        return close(fd) == 0 && ok;
+#endif
+    }
+}
+
+ScoreStore::~ScoreStore()
+{
+    if (!writer.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    writer.join();
+}
+
+void ScoreStore::open(const std::string &path, const std::string &legacyPath)
+{
+    logPath = path;
+
+    std::ifstream log(logPath);
+    bool haveLog = log.is_open();
+    std::string line;
+    bool damaged = false;
+    while (std::getline(log, line))
+    {
+        ScoreRecord record;
+        if (parseLine(line, record))
+        {
+            insertRanked(leaderboard, record);
+            recordsInLog++;
+        }
+        else
+        {
+            damaged = true;
+        }
+    }
+
+    // A torn line would swallow the next append, so rewrite the log on the first write
+    if (damaged)
+        recordsInLog = SCORE_LOG_COMPACT_RECORDS;
+
+    writerBest = leaderboard;
+    writer = std::thread(&ScoreStore::writerLoop, this);
+
+    if (!haveLog)
+    {
+        // Carry the old single high score over into the log
+        std::ifstream legacy(legacyPath);
+        ScoreRecord record;
+        if (legacy >> record.score && record.score > 0)
+        {
+            record.timestamp = (std::int64_t)std::time(nullptr);
+            submit(record);
+        }
+    }
+    changes++;
+}
+
+int ScoreStore::submit(const ScoreRecord &record)
+{
+    int rank = insertRanked(leaderboard, record);
+    if (rank > 0)
+        changes++;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.push_back(record);
+    }
+    queueReady.notify_one();
+    return rank;
+}
+
+void ScoreStore::saveReplay(const Replay &replay)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pendingReplays.push_back(replay);
+    }
+    queueReady.notify_one();
+}
+
+void ScoreStore::writeReplays(const std::deque<Replay> &replays)
+{
+    if (!replaysEnabled)
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(REPLAY_DIRECTORY, error);
+    for (const Replay &replay : replays)
+    {
+        std::string path = std::string(REPLAY_DIRECTORY) + "/run_" + std::to_string(std::time(nullptr)) + "_" + std::to_string(replay.seed) + ".djr";
+        if (!::saveReplay(path, replay))
+        {
+            std::cerr << "Could not create replay file " << path << ", recording disabled\n";
+            replaysEnabled = false;
+            return;
+        }
+    }
+}
+
+void ScoreStore::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true)
+    {
+        queueReady.wait(lock, [&]()
+                        { return stopping || !pending.empty() || !pendingReplays.empty(); });
+        if (pending.empty() && pendingReplays.empty())
+            return;
+
+        std::vector<ScoreRecord> batch(pending.begin(), pending.end());
+        pending.clear();
+        std::deque<Replay> replays;
+        replays.swap(pendingReplays);
+        lock.unlock();
+
+        writeReplays(replays);
+        if (!batch.empty())
+        {
+            if (!writeLines(logPath, "ab", batch))
+            {
+                std::cerr << "Could not append to score log " << logPath << "\n";
+            }
+            for (const ScoreRecord &record : batch)
+            {
+                insertRanked(writerBest, record);
+            }
+            recordsInLog += (int)batch.size();
+
+            if (recordsInLog >= SCORE_LOG_COMPACT_RECORDS && !compact())
+            {
+                std::cerr << "Could not compact score log " << logPath << "\n";
+            }
+        }
+
+        lock.lock();
+    }
+}
+
+bool ScoreStore::compact()
+{
+    // Write the best records aside, then atomically replace the log with them.
+    // Only the top SCORE_STORE_CAPACITY survive; every other run in the history is dropped.
+    std::string temporaryPath = logPath + ".tmp";
+    if (!writeLines(temporaryPath, "wb", writerBest))
+        return false;
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, logPath, error);
+    if (error)
+        return false;
+
+    // Until the directory entry reaches the disk, a crash could bring back the old log
+    if (!syncDirectoryOf(logPath))
+        return false;
+
+    recordsInLog = (int)writerBest.size();
+    return true;
+}
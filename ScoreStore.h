@@ -0,0 +1,92 @@
+#pragma once
+#include "Replay.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char *const SCORE_LOG_PATH = "scores.log";
+const char *const LEGACY_HIGH_SCORE_PATH = "highscore.txt";
+const char *const REPLAY_DIRECTORY = "replays";
+
+// Best runs kept in memory and after compaction
+const int SCORE_STORE_CAPACITY = 100;
+
+// The log is compacted once it holds this many records
+const int SCORE_LOG_COMPACT_RECORDS = 2 * SCORE_STORE_CAPACITY;
+
+struct ScoreRecord
+{
+    std::int64_t timestamp = 0; // Seconds since the Unix epoch
+    int score = 0;
+    int height = 0;             // Pixels climbed
+    int durationMs = 0;         // Simulated run length
+    std::uint64_t replay = 0;   // replayFingerprint of a run a score server accepted; 0 for local runs
+};
+
+// Persistent score history with an in-memory leaderboard.
+//
+// Records are appended to a text log, one checksummed line each, by a
+// background writer thread, so submitting a score never waits on the disk.
+// A torn last line from a crash fails its checksum and is skipped on load.
+// Once the log grows past SCORE_LOG_COMPACT_RECORDS the writer rewrites it
+// with only the best SCORE_STORE_CAPACITY records into a temporary file, renames
+// it over the log and syncs the directory, so a crash during compaction leaves
+// either the old or the new file. Compaction drops every run outside the top
+// SCORE_STORE_CAPACITY; the log is a leaderboard, not a full history.
+// Replays of finished runs are written to REPLAY_DIRECTORY by the same thread.
+//
+// submit() and the queries are for one thread (the game's main thread);
+// saveReplay() may be called from any thread.
+class ScoreStore
+{
+public:
+    ScoreStore() = default;
+    ~ScoreStore();
+
+    ScoreStore(const ScoreStore &) = delete;
+    ScoreStore &operator=(const ScoreStore &) = delete;
+
+    // Load the log and start the writer. The first time, imports the single
+    // score from the legacy high score file.
+    void open(const std::string &logPath = SCORE_LOG_PATH, const std::string &legacyPath = LEGACY_HIGH_SCORE_PATH);
+
+    // Add a finished run; returns its leaderboard rank (1-based), or 0 if it did not place
+    int submit(const ScoreRecord &record);
+
+    // Queue a run's replay to be written as its own file; never waits on the disk
+    void saveReplay(const Replay &replay);
+
+    int best() const { return leaderboard.empty() ? 0 : leaderboard.front().score; }
+
+    // Best runs, highest first
+    const std::vector<ScoreRecord> &top() const { return leaderboard; }
+
+    // Changes whenever the leaderboard does, so UI can rebuild only then
+    int version() const { return changes; }
+
+private:
+    void writerLoop();
+    void writeReplays(const std::deque<Replay> &replays);
+    bool compact();
+
+    std::string logPath;
+    std::vector<ScoreRecord> leaderboard;
+    int changes = 0;
+
+    // Writer thread state
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<ScoreRecord> pending;
+    std::deque<Replay> pendingReplays;
+    bool stopping = false;
+    std::thread writer;
+
+    // Owned by the writer thread once it is running
+    std::vector<ScoreRecord> writerBest;
+    int recordsInLog = 0;
+    bool replaysEnabled = true;
+};
@@ -0,0 +1,280 @@
+#include "ScoreProtocol.h"
+#include "Policies.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Command line client for the score server.
+//
+// Usage: score_client [--host=H] [--port=P] top [N]
+//        score_client [--host=H] [--port=P] submit file.djr [file.djr ...]
+//        score_client [--host=H] [--port=P] load [--runs=R] [--batch=B] [--connections=C] [--window=W] [--seconds=S]
+//
+// load plays R short games with random input, tampers with the claimed score of
+// every 16th, and submits them in batches of B over C connections, keeping W
+// batches in flight on each, for S seconds. Batches are sent round and round,
+// so after its first acceptance each honest run must come back rejected as a
+// repeat. Seeds are new on every invocation, so the server has not seen them.
+// It prints the submission rate and exits with status 1 if any run was judged
+// wrongly.
+
+namespace
+{
+    const int CONNECT_TIMEOUT_MS = 5000;
+
+    // Every this many generated runs claims a score it did not reach
+    const int TAMPERED_EVERY = 16;
+
+    // Send one request and wait for its reply; returns the reply size, or 0 on failure
+    size_t request(SocketHandle socket, const std::vector<std::uint8_t> &message, std::vector<std::uint8_t> &buffer)
+    {
+        buffer.clear();
+        return sendAll(socket, message) ? receiveMessage(socket, buffer) : 0;
+    }
+
+    int showTop(SocketHandle socket, int rows)
+    {
+        std::vector<std::uint8_t> message, buffer;
+        encodeTop(message, 1, rows);
+        size_t size = request(socket, message, buffer);
+        MessageReader reply(buffer.data(), size);
+        std::vector<ScoreRecord> top;
+        if (size == 0 || reply.type() != SCORE_TOP_RESULT || !decodeTopResult(reply, top))
+        {
+            std::cerr << "No reply from server\n";
+            return 1;
+        }
+
+        for (size_t i = 0; i < top.size(); i++)
+        {
+            std::cout << std::setw(3) << i + 1 << ".  " << std::setw(6) << top[i].score << "  height " << top[i].height
+                      << "  " << top[i].durationMs / 1000 << " s\n";
+        }
+        if (top.empty())
+            std::cout << "No runs yet\n";
+        return 0;
+    }
+
+    int submitFiles(SocketHandle socket, const std::vector<std::string> &paths)
+    {
+        std::vector<Replay> replays;
+        std::vector<std::string> names;
+        for (const std::string &path : paths)
+        {
+            Replay replay;
+            std::string error;
+            if (loadReplay(path, replay, error))
+            {
+                replays.push_back(replay);
+                names.push_back(path);
+            }
+            else
+            {
+                std::cout << "ERROR    " << path << ": " << error << "\n";
+            }
+        }
+
+        int failures = (int)(paths.size() - replays.size());
+        for (size_t first = 0; first < replays.size(); first += SCORE_MAX_BATCH)
+        {
+            std::vector<Replay> batch(replays.begin() + first, replays.begin() + std::min(first + SCORE_MAX_BATCH, replays.size()));
+            std::vector<std::uint8_t> message, buffer;
+            encodeSubmit(message, (std::uint32_t)first, batch);
+            size_t size = request(socket, message, buffer);
+            MessageReader reply(buffer.data(), size);
+            std::vector<SubmitResult> results;
+            if (size == 0 || reply.type() != SCORE_SUBMIT_RESULT || !decodeSubmitResult(reply, results) || results.size() != batch.size())
+            {
+                std::cerr << "No reply from server\n";
+                return 1;
+            }
+
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                const std::string &name = names[first + i];
+                if (results[i].accepted)
+                    std::cout << "ACCEPTED " << name << " score " << results[i].score << (results[i].rank ? " rank " + std::to_string(results[i].rank) : "") << "\n";
+                else
+                    std::cout << "REJECTED " << name << "\n";
+                failures += results[i].accepted ? 0 : 1;
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    // A short finished game with random input; the tampered ones overstate their score
+    Replay randomRun(std::uint64_t seed, bool tampered)
+    {
+        Replay replay;
+        replay.seed = seed;
+        GameSim sim(seed);
+        RandomPolicy policy(seed);
+        while (!sim.gameOver && replay.totalTicks < SCORE_MAX_REPLAY_TICKS)
+        {
+            GameInput input = policy.next();
+            appendInput(replay, input);
+            sim.step(input);
+        }
+        replay.finalScore = sim.currentScore + (tampered ? 100 : 0);
+        replay.endedInGameOver = sim.gameOver;
+        return replay;
+    }
+
+    int loadTest(const std::string &host, int port, int argc, char **argv, int first)
+    {
+        int runCount = 1024, batchSize = 64, connectionCount = 4, window = 4;
+        double seconds = 5;
+        for (int i = first; i < argc; i++)
+        {
+            if (std::strncmp(argv[i], "--runs=", 7) == 0)
+                runCount = std::max(1, std::atoi(argv[i] + 7));
+            else if (std::strncmp(argv[i], "--batch=", 8) == 0)
+                batchSize = std::clamp(std::atoi(argv[i] + 8), 1, SCORE_MAX_BATCH);
+            else if (std::strncmp(argv[i], "--connections=", 14) == 0)
+                connectionCount = std::max(1, std::atoi(argv[i] + 14));
+            else if (std::strncmp(argv[i], "--window=", 9) == 0)
+                window = std::max(1, std::atoi(argv[i] + 9));
+            else if (std::strncmp(argv[i], "--seconds=", 10) == 0)
+                seconds = std::max(0.1, std::atof(argv[i] + 10));
+        }
+
+        // Every batch is encoded once up front, so the clients only measure the server
+        std::uint64_t baseSeed = (std::uint64_t)std::chrono::system_clock::now().time_since_epoch().count();
+        std::vector<Replay> runs;
+        long long ticks = 0;
+        for (int i = 0; i < runCount; i++)
+        {
+            runs.push_back(randomRun(baseSeed + (std::uint64_t)i, i % TAMPERED_EVERY == TAMPERED_EVERY - 1));
+            ticks += runs.back().totalTicks;
+        }
+        std::vector<std::vector<std::uint8_t>> batches;
+        for (int firstRun = 0; firstRun < runCount; firstRun += batchSize)
+        {
+            std::vector<Replay> batch(runs.begin() + firstRun, runs.begin() + std::min(firstRun + batchSize, runCount));
+            batches.emplace_back();
+            encodeSubmit(batches.back(), (std::uint32_t)firstRun, batch);
+        }
+        std::cout << runCount << " runs of " << ticks / runCount << " ticks on average in " << batches.size() << " batches\n";
+
+        std::atomic<long long> submitted{0}, misjudged{0};
+        std::atomic<int> failedConnections{0};
+        std::vector<std::atomic<int>> answers(runCount), acceptances(runCount);
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+
+        std::vector<std::thread> clients;
+        for (int c = 0; c < connectionCount; c++)
+        {
+            clients.emplace_back([&, c]()
+                                 {
+                std::string error;
+                SocketHandle socket = connectToServer(host, port, CONNECT_TIMEOUT_MS, error);
+                if (socket == INVALID_SOCKET_HANDLE)
+                {
+                    failedConnections++;
+                    return;
+                }
+
+                // Keep the window full until the deadline, then collect what is still in flight
+                size_t next = (size_t)c;
+                int inflight = 0;
+                std::vector<std::uint8_t> buffer;
+                std::vector<SubmitResult> results;
+                bool ok = true;
+                while (ok && (inflight > 0 || std::chrono::steady_clock::now() < deadline))
+                {
+                    while (ok && inflight < window && std::chrono::steady_clock::now() < deadline)
+                    {
+                        ok = sendAll(socket, batches[next % batches.size()]);
+                        next++;
+                        inflight++;
+                    }
+                    size_t size = ok ? receiveMessage(socket, buffer) : 0;
+                    MessageReader reply(buffer.data(), size);
+                    ok = size > 0 && reply.type() == SCORE_SUBMIT_RESULT && decodeSubmitResult(reply, results);
+                    if (!ok)
+                        break;
+
+                    int firstRun = (int)reply.requestId();
+                    for (size_t i = 0; i < results.size(); i++)
+                    {
+                        const Replay &run = runs[firstRun + i];
+                        bool tampered = (firstRun + i) % TAMPERED_EVERY == TAMPERED_EVERY - 1;
+                        answers[firstRun + i]++;
+                        if (results[i].accepted)
+                            acceptances[firstRun + i]++;
+                        if (results[i].accepted && (tampered || results[i].score != run.finalScore))
+                            misjudged++;
+                    }
+                    submitted += (long long)results.size();
+                    buffer.erase(buffer.begin(), buffer.begin() + size);
+                    inflight--;
+                }
+                if (!ok)
+                    failedConnections++;
+                closeSocket(socket); });
+        }
+        for (std::thread &client : clients)
+            client.join();
+
+        // Every honest run that was answered must have been accepted exactly once
+        for (int i = 0; i < runCount; i++)
+        {
+            bool tampered = i % TAMPERED_EVERY == TAMPERED_EVERY - 1;
+            if (!tampered && answers[i] > 0 && acceptances[i] != 1)
+                misjudged++;
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << submitted << " runs validated in " << elapsed << " s (" << (long long)(submitted / elapsed)
+                  << " runs/s, " << (long long)(submitted * (double)ticks / runCount / elapsed) << " ticks/s), "
+                  << misjudged << " misjudged, " << failedConnections << " connections failed\n";
+        return misjudged == 0 && failedConnections == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string host = "127.0.0.1";
+    int port = SCORE_SERVER_PORT;
+    int i = 1;
+    for (; i < argc && std::strncmp(argv[i], "--", 2) == 0; i++)
+    {
+        if (std::strncmp(argv[i], "--host=", 7) == 0)
+            host = argv[i] + 7;
+        else if (std::strncmp(argv[i], "--port=", 7) == 0)
+            port = std::atoi(argv[i] + 7);
+    }
+
+    std::string command = i < argc ? argv[i++] : "";
+    if (command == "load")
+        return loadTest(host, port, argc, argv, i);
+    if (command != "top" && command != "submit")
+    {
+        std::cerr << "Usage: score_client [--host=H] [--port=P] top [N] | submit file.djr ... | load [--runs=R] [--batch=B] "
+                     "[--connections=C] [--window=W] [--seconds=S]\n";
+        return 1;
+    }
+
+    std::string error;
+    SocketHandle socket = connectToServer(host, port, CONNECT_TIMEOUT_MS, error);
+    if (socket == INVALID_SOCKET_HANDLE)
+    {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    int status = 0;
+    if (command == "top")
+        status = showTop(socket, i < argc ? std::max(1, std::atoi(argv[i])) : 10);
+    else
+        status = submitFiles(socket, std::vector<std::string>(argv + i, argv + argc));
+    closeSocket(socket);
+    return status;
+}
@@ -0,0 +1,65 @@
+#include "ScoreServer.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Shared leaderboard server for several game stations on one network. Stations
+// submit finished runs as replays; each is re-simulated before it can rank.
+//
+// Usage: score_server [--port=P] [--threads=T] [--log=FILE]
+// Runs until interrupted.
+
+namespace
+{
+    ScoreServer *runningServer = nullptr;
+
+    void stopServer(int)
+    {
+        if (runningServer)
+            runningServer->stop();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int port = SCORE_SERVER_PORT;
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    std::string logPath = "server_scores.log";
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strncmp(argv[i], "--port=", 7) == 0)
+            port = std::atoi(argv[i] + 7);
+        else if (std::strncmp(argv[i], "--threads=", 10) == 0)
+            threadCount = (unsigned int)std::max(1, std::atoi(argv[i] + 10));
+        else if (std::strncmp(argv[i], "--log=", 6) == 0)
+            logPath = argv[i] + 6;
+        else
+        {
+            std::cerr << "Usage: score_server [--port=P] [--threads=T] [--log=FILE]\n";
+            return 1;
+        }
+    }
+
+    ScoreServer server(threadCount);
+    std::string error;
+    if (!server.open(port, logPath, error))
+    {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    runningServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    std::cout << "Listening on port " << port << " with " << threadCount << " validation threads, log " << logPath << "\n";
+
+    server.run();
+
+    runningServer = nullptr;
+    std::cout << server.acceptedRuns() << " runs accepted, " << server.rejectedRuns() << " rejected\n";
+    return 0;
+}
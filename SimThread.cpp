@@ -0,0 +1,258 @@
+#include "SimThread.h"
+#include <algorithm>
+#include <ctime>
+
+namespace
+{
+    // Longest stretch of time the simulation catches up on; anything slower is treated as a stall
+    const double MAX_CATCH_UP_SECONDS = 0.25;
+
+    // Sleep in short slices until close to the deadline, then spin so ticks start on time
+    void waitUntil(SimThread::Clock::time_point deadline, const std::atomic<bool> &stopping)
+    {
+        const auto spinMargin = std::chrono::milliseconds(2);
+        while (!stopping.load(std::memory_order_relaxed))
+        {
+            SimThread::Clock::time_point now = SimThread::Clock::now();
+            if (now >= deadline)
+                return;
+            if (deadline - now > spinMargin)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            else
+                std::this_thread::yield();
+        }
+    }
+}
+
+SimThread::SimThread(ReplaySink saveReplay)
+    : sim((std::uint64_t)time(0)), saveReplay(std::move(saveReplay))
+{
+    sim.chunkSource = levelStreamer.source();
+    worker = std::thread(&SimThread::run, this);
+}
+
+SimThread::~SimThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        stopping.store(true, std::memory_order_release);
+    }
+    commandPosted.notify_one();
+    worker.join();
+}
+
+std::uint32_t SimThread::startRun(std::uint64_t seed, GameMode mode)
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+    startRequested = true;
+    abandonRequested = false;
+    requestedSeed = seed;
+    requestedMode = mode;
+    paused.store(false, std::memory_order_relaxed);
+    post();
+    return ++requestedRun;
+}
+
+void SimThread::setPaused(bool value)
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+    paused.store(value, std::memory_order_relaxed);
+    post();
+}
+
+void SimThread::abandonRun()
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+    abandonRequested = true;
+    post();
+}
+
+void SimThread::pushKey(Clock::time_point time, std::uint8_t mask, bool pressed)
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+    inputQueue.push(time, mask, pressed);
+    post();
+}
+
+void SimThread::releaseKeys(Clock::time_point time)
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+    inputQueue.releaseAll(time);
+    post();
+}
+
+void SimThread::post()
+{
+    // Called with commandMutex held, so an idle simulation thread cannot miss it
+    posted = true;
+    commandPosted.notify_one();
+}
+
+const SimSnapshot &SimThread::latest()
+{
+    snapshots.update();
+    return snapshots.front();
+}
+
+bool SimThread::takeFinishedRun(std::uint32_t run, Replay &replay)
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+    if (finishedRun != run)
+        return false;
+    replay = std::move(finishedReplay);
+    finishedRun = 0;
+    return true;
+}
+
+SimThread::Clock::duration SimThread::takePhaseTime(ProfilePhase phase)
+{
+    return std::chrono::nanoseconds(phaseNanoseconds[phase].exchange(0, std::memory_order_relaxed));
+}
+
+void SimThread::closeReplay(bool gameOver)
+{
+    // Each run is handed over once, whether it ends in game over, is abandoned or the game quits
+    if (!replayOpen)
+        return;
+    replayOpen = false;
+
+    currentReplay.finalScore = sim.currentScore;
+    currentReplay.endedInGameOver = gameOver;
+    if (saveReplay)
+        saveReplay(currentReplay);
+    if (gameOver)
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        finishedReplay = std::move(currentReplay);
+        finishedRun = currentRun;
+    }
+}
+
+void SimThread::run()
+{
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(TICK_SECONDS));
+    const auto maxCatchUp = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(MAX_CATCH_UP_SECONDS));
+    Clock::time_point simTime = Clock::now();
+
+    while (!stopping.load(std::memory_order_acquire))
+    {
+        bool start = false, abandon = false;
+        std::uint64_t seed = 0;
+        GameMode mode = MODE_NORMAL;
+        {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            start = startRequested;
+            abandon = abandonRequested;
+            seed = requestedSeed;
+            mode = requestedMode;
+            if (start)
+                currentRun = requestedRun;
+            startRequested = false;
+            abandonRequested = false;
+            posted = false;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (abandon && running)
+        {
+            closeReplay(false);
+            running = false;
+        }
+        if (start)
+        {
+            closeReplay(false);
+            sim.setParams(paramsFor(mode));
+            sim.reset(seed);
+            levelStreamer.start(sim.levelSeed, sim.params, sim.chunk.index + 1);
+            currentReplay = Replay();
+            currentReplay.seed = seed;
+            currentReplay.mode = mode;
+            replayOpen = true;
+            running = true;
+            simTime = now;
+        }
+
+        bool ticking = running && !sim.gameOver && !paused.load(std::memory_order_relaxed);
+        if (ticking)
+        {
+            simTime = std::max(simTime, now - maxCatchUp);
+            while (simTime + tickDuration <= now && !sim.gameOver)
+            {
+                simTime += tickDuration;
+                tick(simTime);
+            }
+        }
+        else
+        {
+            // No ticks run outside play, but key state still follows the events
+            simTime = now;
+            std::lock_guard<std::mutex> lock(commandMutex);
+            inputQueue.advanceTo(now);
+        }
+
+        publish(simTime);
+        if (ticking)
+        {
+            waitUntil(simTime + tickDuration, stopping);
+        }
+        else
+        {
+            // Menu, pause and game over change nothing until a command or input arrives
+            std::unique_lock<std::mutex> lock(commandMutex);
+            commandPosted.wait(lock, [this]()
+                               { return posted || stopping.load(std::memory_order_relaxed); });
+        }
+    }
+
+    // Close out a run abandoned by quitting
+    closeReplay(false);
+}
+
+void SimThread::tick(Clock::time_point tickEnd)
+{
+    Clock::time_point start = Clock::now();
+    GameInput input;
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        input = inputQueue.advanceTo(tickEnd);
+
+        Clock::time_point pressTime;
+        if (inputQueue.lastPressTime(pressTime))
+        {
+            pressCount++;
+            lastPressTime = pressTime;
+        }
+    }
+    appendInput(currentReplay, input);
+    Clock::time_point inputDone = Clock::now();
+
+    sim.movePlayer(input);
+    Clock::time_point physicsDone = Clock::now();
+
+    sim.scrollCamera();
+    Clock::time_point recycleDone = Clock::now();
+
+    if (sim.gameOver)
+    {
+        closeReplay(true);
+    }
+
+    auto addPhase = [&](ProfilePhase phase, Clock::duration elapsed)
+    {
+        phaseNanoseconds[phase].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+    };
+    addPhase(PHASE_INPUT, inputDone - start);
+    addPhase(PHASE_PHYSICS, physicsDone - inputDone);
+    addPhase(PHASE_RECYCLE, recycleDone - physicsDone);
+}
+
+void SimThread::publish(Clock::time_point time)
+{
+    SimSnapshot &snapshot = snapshots.back();
+    snapshot.run = currentRun;
+    snapshot.time = time;
+    snapshot.capture(sim);
+    snapshot.pressCount = pressCount;
+    snapshot.lastPressTime = lastPressTime;
+    snapshots.publish();
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "GameSim.h"
+#include "InputQueue.h"
+#include "LevelStreamer.h"
+#include "FrameProfiler.h"
+#include "Replay.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Everything the renderer needs from one simulation tick
+struct SimSnapshot
+{
+    // Game this snapshot belongs to; 0 before the first game starts
+    std::uint32_t run = 0;
+
+    // Wall-clock end of the last simulated tick, for interpolation
+    InputQueue::Clock::time_point time;
+
+    int platformCount = 0;
+    int platformX[PLATFORM_CAPACITY] = {};
+    int platformY[PLATFORM_CAPACITY] = {};
+
+    float x = 0, y = 0;
+    float prevX = 0, prevY = 0;
+    int lastScroll = 0;
+    int score = 0;
+    int heightClimbed = 0;
+    int ticks = 0;
+    bool gameOver = false;
+
+    // Landing count and the latest landing, for effects
+    int landings = 0;
+    float landingX = 0, landingY = 0;
+    bool landingBonus = false;
+
+    // Movement presses applied so far and when the latest one happened, for --latency-test
+    std::uint32_t pressCount = 0;
+    InputQueue::Clock::time_point lastPressTime;
+
+    // Copy the drawable game state out of a simulation
+    void capture(const GameSim &sim)
+    {
+        platformCount = sim.platforms.size();
+        for (int i = 0; i < platformCount; i++)
+        {
+            platformX[i] = sim.platforms.x(i);
+            platformY[i] = sim.platforms.y(i);
+        }
+        x = sim.x;
+        y = sim.y;
+        prevX = sim.prevX;
+        prevY = sim.prevY;
+        lastScroll = sim.lastScroll;
+        score = sim.currentScore;
+        heightClimbed = sim.heightClimbed;
+        ticks = sim.frameCounter;
+        gameOver = sim.gameOver;
+        landings = sim.landings;
+        landingX = sim.landingX;
+        landingY = sim.landingY;
+        landingBonus = sim.landingBonus;
+    }
+};
+
+// Runs the game simulation on its own thread at TICK_RATE, independent of rendering.
+//
+// The render thread sends input and game commands in, and reads back the latest
+// complete tick through a lock-free triple buffer, so a slow present never delays
+// a tick and a slow tick never blocks a frame. Input events and commands share a
+// short mutex; they are rare next to snapshot reads. Replays are recorded here in
+// memory, on the thread that knows exactly which input each tick used, and handed
+// to a sink when the run ends; the sink must not block, so files are written
+// elsewhere. Upcoming level chunks are generated ahead of time on a further worker thread.
+class SimThread
+{
+public:
+    using Clock = InputQueue::Clock;
+
+    // Receives every run's replay once it ends, on the simulation thread
+    using ReplaySink = std::function<void(const Replay &)>;
+
+    // An empty sink records replays only for takeFinishedRun
+    explicit SimThread(ReplaySink saveReplay = ReplaySink());
+    ~SimThread();
+
+    SimThread(const SimThread &) = delete;
+    SimThread &operator=(const SimThread &) = delete;
+
+    // Start a new game from a seed; returns the run number its snapshots will carry
+    std::uint32_t startRun(std::uint64_t seed, GameMode mode = MODE_NORMAL);
+
+    // Stop ticking without ending the game
+    void setPaused(bool paused);
+
+    // End the current game early; its replay is closed as abandoned
+    void abandonRun();
+
+    void pushKey(Clock::time_point time, std::uint8_t mask, bool pressed);
+    void releaseKeys(Clock::time_point time);
+
+    // Latest complete snapshot. Only the render thread may call this.
+    const SimSnapshot &latest();
+
+    // Time the simulation spent in a phase since the last call, for the frame profiler
+    Clock::duration takePhaseTime(ProfilePhase phase);
+
+    // The replay of the given run once it has ended in game over, for submitting it elsewhere.
+    // Ready by the time a snapshot shows the game over.
+    bool takeFinishedRun(std::uint32_t run, Replay &replay);
+
+private:
+    void run();
+    void tick(Clock::time_point tickEnd);
+    void publish(Clock::time_point time);
+    void closeReplay(bool gameOver);
+    void post();
+
+    // Owned by the simulation thread
+    LevelStreamer levelStreamer;
+    GameSim sim;
+    ReplaySink saveReplay;
+    Replay currentReplay;
+    bool replayOpen = false;
+    bool running = false;
+    std::uint32_t currentRun = 0;
+    std::uint32_t pressCount = 0;
+    Clock::time_point lastPressTime;
+
+    // Shared with the render thread under commandMutex. Outside play the simulation
+    // thread sleeps on commandPosted until a command or input arrives.
+    std::mutex commandMutex;
+    std::condition_variable commandPosted;
+    bool posted = false;
+    InputQueue inputQueue;
+    bool startRequested = false;
+    bool abandonRequested = false;
+    std::uint64_t requestedSeed = 0;
+    GameMode requestedMode = MODE_NORMAL;
+    std::uint32_t requestedRun = 0;
+    Replay finishedReplay;
+    std::uint32_t finishedRun = 0;
+
+    std::atomic<bool> paused{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::int64_t> phaseNanoseconds[PHASE_COUNT] = {};
+
+    TripleBuffer<SimSnapshot> snapshots;
+    std::thread worker;
+};
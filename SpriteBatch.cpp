@@ -0,0 +1,93 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+namespace
+{
+    const size_t VERTICES_PER_QUAD = 6;
+
+    bool sameVertex(const sf::Vertex &a, const sf::Vertex &b)
+    {
+        return a.position == b.position && a.texCoords == b.texCoords && a.color == b.color;
+    }
+}
+
+SpriteBatch::SpriteBatch(size_t quadCount)
+    : vertices(quadCount * VERTICES_PER_QUAD),
+      buffer(sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Stream),
+      useBuffer(sf::VertexBuffer::isAvailable())
+{
+    if (useBuffer)
+    {
+        useBuffer = buffer.create(vertices.size());
+    }
+    dirtyBegin = 0;
+    dirtyEnd = vertices.size();
+}
+
+void SpriteBatch::setQuad(size_t index, sf::Vector2f position, const sf::IntRect &region)
+{
+    sf::Vector2f size(region.size);
+    sf::Vector2f uv(region.position);
+
+    sf::Vertex topLeft{position, sf::Color::White, uv};
+    sf::Vertex topRight{position + sf::Vector2f(size.x, 0), sf::Color::White, uv + sf::Vector2f(size.x, 0)};
+    sf::Vertex bottomLeft{position + sf::Vector2f(0, size.y), sf::Color::White, uv + sf::Vector2f(0, size.y)};
+    sf::Vertex bottomRight{position + size, sf::Color::White, uv + size};
+
+    const sf::Vertex quad[6] = {topLeft, topRight, bottomLeft, bottomLeft, topRight, bottomRight};
+    writeQuad(index, quad);
+}
+
+void SpriteBatch::hideQuad(size_t index)
+{
+    const sf::Vertex quad[6] = {};
+    writeQuad(index, quad);
+}
+
+void SpriteBatch::writeQuad(size_t index, const sf::Vertex (&quad)[6])
+{
+    size_t first = index * VERTICES_PER_QUAD;
+
+    bool changed = false;
+    for (size_t i = 0; i < VERTICES_PER_QUAD; i++)
+    {
+        if (!sameVertex(vertices[first + i], quad[i]))
+        {
+            vertices[first + i] = quad[i];
+            changed = true;
+        }
+    }
+
+    if (changed)
+    {
+        dirtyBegin = std::min(dirtyBegin, first);
+        dirtyEnd = std::max(dirtyEnd, first + VERTICES_PER_QUAD);
+    }
+}
+
+void SpriteBatch::draw(sf::RenderTarget &target, const sf::Texture &texture, size_t quadCount)
+{
+    size_t vertexCount = std::min(quadCount * VERTICES_PER_QUAD, vertices.size());
+
+    if (!useBuffer)
+    {
+        // No vertex buffer support: still a single draw call, streamed from client memory
+        target.draw(vertices.data(), vertexCount, sf::PrimitiveType::Triangles, sf::RenderStates(&texture));
+        return;
+    }
+
+    // Upload only the span of quads that changed since the last frame
+    if (dirtyBegin < dirtyEnd)
+    {
+        if (!buffer.update(vertices.data() + dirtyBegin, dirtyEnd - dirtyBegin, (unsigned int)dirtyBegin))
+        {
+            useBuffer = false;
+            draw(target, texture, quadCount);
+            return;
+        }
+        dirtyBegin = vertices.size();
+        dirtyEnd = 0;
+    }
+
+    target.draw(buffer, 0, vertexCount, sf::RenderStates(&texture));
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// A fixed set of textured quads drawn with one draw call. Quads keep their slot
+// between frames and only slots whose geometry changed are re-uploaded to the GPU.
+class SpriteBatch
+{
+public:
+    explicit SpriteBatch(size_t quadCount);
+
+    // Place a quad showing a texture region at a position; no-op if nothing changed
+    void setQuad(size_t index, sf::Vector2f position, const sf::IntRect &region);
+
+    // Collapse a quad so it draws nothing
+    void hideQuad(size_t index);
+
+    // Draw the first quadCount quads with a single draw call
+    void draw(sf::RenderTarget &target, const sf::Texture &texture, size_t quadCount);
+
+private:
+    void writeQuad(size_t index, const sf::Vertex (&quad)[6]);
+
+    std::vector<sf::Vertex> vertices;
+    sf::VertexBuffer buffer;
+    bool useBuffer;
+
+    // Vertex range modified since the last upload
+    size_t dirtyBegin;
+    size_t dirtyEnd;
+};
@@ -0,0 +1,55 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    const unsigned int ATLAS_MAX_WIDTH = 1024;
+
+    // Gap between packed images so neighbours never bleed into each other
+    const unsigned int ATLAS_PADDING = 1;
+}
+
+bool TextureAtlas::pack(const std::vector<sf::Image> &images, std::string &error)
+{
+    // Shelf packing: place the tallest images first, left to right, starting a new row when full
+    std::vector<size_t> order(images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+              { return images[a].getSize().y > images[b].getSize().y; });
+
+    regions.assign(images.size(), sf::IntRect());
+    unsigned int cursorX = 0, cursorY = 0, rowHeight = 0, atlasWidth = 0;
+    for (size_t index : order)
+    {
+        sf::Vector2u size = images[index].getSize();
+        if (cursorX > 0 && cursorX + size.x > ATLAS_MAX_WIDTH)
+        {
+            cursorX = 0;
+            cursorY += rowHeight + ATLAS_PADDING;
+            rowHeight = 0;
+        }
+        regions[index] = sf::IntRect(sf::Vector2i((int)cursorX, (int)cursorY), sf::Vector2i(size));
+        cursorX += size.x + ATLAS_PADDING;
+        rowHeight = std::max(rowHeight, size.y);
+        atlasWidth = std::max(atlasWidth, cursorX);
+    }
+
+    packed = sf::Image(sf::Vector2u(std::max(1u, atlasWidth), std::max(1u, cursorY + rowHeight)), sf::Color::Transparent);
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        if (!packed.copy(images[i], sf::Vector2u(regions[i].position)))
+        {
+            error = "cannot pack image " + std::to_string(i) + " into the texture atlas";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TextureAtlas::upload()
+{
+    bool loaded = texture.loadFromImage(packed);
+    packed = sf::Image();
+    return loaded;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+// Packs several images into one texture at startup so everything drawn from
+// it shares a single texture bind. Regions are returned in load order.
+//
+// Building is split in two: pack() only touches CPU images and may run on a
+// worker thread, upload() creates the GPU texture and must run on the thread
+// that owns the window.
+class TextureAtlas
+{
+public:
+    // Pack decoded images into one CPU-side image; thread-safe as long as the atlas is not in use.
+    // Returns false and fills error on failure, leaving the caller to report it.
+    bool pack(const std::vector<sf::Image> &images, std::string &error);
+
+    // Move the packed image into the texture and release the CPU copy
+    bool upload();
+
+    const sf::Texture &getTexture() const { return texture; }
+    const sf::IntRect &region(size_t index) const { return regions[index]; }
+
+private:
+    sf::Image packed;
+    sf::Texture texture;
+    std::vector<sf::IntRect> regions;
+};
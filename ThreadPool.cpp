@@ -0,0 +1,141 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace
+{
+    // Pool worker running on this thread and its index, or null for outside threads.
+    // Keyed by pool so a task that submits to a different pool is treated as outside work.
+    struct WorkerSlot
+    {
+        const ThreadPool *pool = nullptr;
+        unsigned int index = 0;
+    };
+    thread_local WorkerSlot currentWorker;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    threadCount = std::max(1u, threadCount);
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back([this, i]()
+                             { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    // Workers keep their own spawned work local; outside submissions, including ones from
+    // other pools' workers, are spread round-robin
+    unsigned int index = currentWorker.pool == this ? currentWorker.index
+                                                    : nextQueue.fetch_add(1) % (unsigned int)queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queuedTasks++;
+        unfinishedTasks++;
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this]()
+                 { return unfinishedTasks == 0; });
+}
+
+void ThreadPool::parallelFor(int count, int grain, const std::function<void(int, int)> &fn)
+{
+    grain = std::max(1, grain);
+    for (int begin = 0; begin < count; begin += grain)
+    {
+        int end = std::min(count, begin + grain);
+        submit([&fn, begin, end]()
+               { fn(begin, end); });
+    }
+    wait();
+}
+
+bool ThreadPool::takeTask(unsigned int index, std::function<void()> &task)
+{
+    // Newest local work first for cache warmth
+    {
+        WorkerQueue &own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest work from the other workers
+    for (unsigned int offset = 1; offset < queues.size(); offset++)
+    {
+        WorkerQueue &victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned int index)
+{
+    currentWorker.pool = this;
+    currentWorker.index = index;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            workAvailable.wait(lock, [this]()
+                               { return queuedTasks > 0 || stopping; });
+            if (queuedTasks == 0 && stopping)
+                return;
+
+            // Claim one task; tasks are pushed before they are counted, so one is guaranteed to exist
+            queuedTasks--;
+        }
+
+        std::function<void()> task;
+        while (!takeTask(index, task))
+        {
+            std::this_thread::yield();
+        }
+
+        task();
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (--unfinishedTasks == 0)
+        {
+            allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Each worker owns a deque: it pops its own work
+// from the back and, when empty, steals the oldest work from other workers.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished. Must not be called from a worker.
+    void wait();
+
+    // Run fn(begin, end) over [0, count) in chunks of at most grain items and wait for completion
+    void parallelFor(int count, int grain, const std::function<void(int, int)> &fn);
+
+    unsigned int size() const { return (unsigned int)workers.size(); }
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(unsigned int index);
+    bool takeTask(unsigned int index, std::function<void()> &task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    int queuedTasks = 0;
+    int unfinishedTasks = 0;
+    bool stopping = false;
+    std::atomic<unsigned int> nextQueue{0};
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+
+// Lock-free single-writer, single-reader triple buffer.
+//
+// The writer fills back() and publishes it; the reader picks up the most
+// recently published value with update() and reads it through front(). Each
+// side owns one slot and the third is swapped through a single atomic, so
+// neither side ever waits and the reader never sees a half-written value.
+// Values the reader did not get to in time are simply skipped.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side
+    T &back() { return slots[backIndex].value; }
+
+    void publish()
+    {
+        backIndex = shared.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side: switch to the latest published value. Returns false if nothing new was published.
+    bool update()
+    {
+        if ((shared.load(std::memory_order_relaxed) & FRESH) == 0)
+            return false;
+        frontIndex = shared.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T &front() const { return slots[frontIndex].value; }
+
+private:
+    static const unsigned INDEX_MASK = 3;
+    static const unsigned FRESH = 4;
+
+    // Each slot on its own cache line so the two threads never share one
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    Slot slots[3];
+    unsigned backIndex = 0;
+    unsigned frontIndex = 1;
+    std::atomic<unsigned> shared{2};
+};
@@ -0,0 +1,168 @@
+#include "Ui.h"
+#include <charconv>
+
+void prewarmDigitGlyphs(const sf::Font &font, std::initializer_list<unsigned int> sizes)
+{
+    for (unsigned int size : sizes)
+    {
+        for (char32_t digit = U'0'; digit <= U'9'; digit++)
+        {
+            font.getGlyph(digit, size, false);
+        }
+    }
+}
+
+Label::Label(const sf::Font &font, const std::string &string, unsigned int size, sf::Color color)
+    : text(font), current(string)
+{
+    text.setCharacterSize(size);
+    text.setFillColor(color);
+    text.setString(string);
+}
+
+void Label::setString(const std::string &string)
+{
+    if (string == current)
+        return;
+    current = string;
+    text.setString(current);
+    dirty = true;
+}
+
+void Label::setNumber(int value)
+{
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    size_t length = (size_t)(result.ptr - digits);
+
+    // Compare in place so an unchanged value costs no allocation
+    if (current.compare(0, std::string::npos, digits, length) == 0)
+        return;
+    current.assign(digits, length);
+    text.setString(current);
+    dirty = true;
+}
+
+void Label::setPosition(sf::Vector2f position)
+{
+    if (!centered && position == anchor)
+        return;
+    anchor = position;
+    centered = false;
+    dirty = true;
+}
+
+void Label::setCentered(float width, float y)
+{
+    if (centered && width == centerWidth && y == anchor.y)
+        return;
+    centerWidth = width;
+    anchor = sf::Vector2f(0, y);
+    centered = true;
+    dirty = true;
+}
+
+void Label::layout()
+{
+    if (centered)
+    {
+        float x = (centerWidth - text.getGlobalBounds().size.x) / 2;
+        text.setPosition(sf::Vector2f(x, anchor.y));
+    }
+    else
+    {
+        text.setPosition(anchor);
+    }
+    dirty = false;
+}
+
+void Label::draw(sf::RenderTarget &target)
+{
+    if (dirty)
+        layout();
+    target.draw(text);
+}
+
+Button::Button(const sf::Font &font, const std::string &label, sf::Vector2f position, sf::Vector2f size, unsigned int fontSize)
+    : background(size), text(font), bounds(position, size)
+{
+    background.setPosition(position);
+    background.setOutlineThickness(2.0f);
+
+    text.setString(label);
+    text.setCharacterSize(fontSize);
+    centerText();
+    restyle();
+}
+
+void Button::setLabel(const std::string &label)
+{
+    text.setString(label);
+    centerText();
+}
+
+void Button::centerText()
+{
+    // Text is measured only when the label changes rather than every frame
+    sf::FloatRect textBounds = text.getLocalBounds();
+    float textX = bounds.position.x + (bounds.size.x - textBounds.size.x) / 2 - textBounds.position.x;
+    float textY = bounds.position.y + (bounds.size.y - textBounds.size.y) / 2 - textBounds.position.y;
+    text.setPosition(sf::Vector2f(textX, textY));
+}
+
+bool Button::setHovered(bool isHovered)
+{
+    if (isHovered == hovered)
+        return false;
+    hovered = isHovered;
+    restyle();
+    return true;
+}
+
+void Button::restyle()
+{
+    background.setFillColor(hovered ? sf::Color(60, 70, 100) : sf::Color(30, 40, 70));
+    background.setOutlineColor(hovered ? HOVER_COLOR : sf::Color(100, 120, 150));
+    text.setFillColor(hovered ? HOVER_COLOR : TEXT_COLOR);
+}
+
+void Button::draw(sf::RenderTarget &target) const
+{
+    target.draw(background);
+    target.draw(text);
+}
+
+ScoreCounter::ScoreCounter(const sf::Font &font, unsigned int size, sf::Color color, sf::Color shadowColor)
+    : shadow(font), text(font)
+{
+    shadow.setCharacterSize(size);
+    shadow.setFillColor(shadowColor);
+    text.setCharacterSize(size);
+    text.setFillColor(color);
+    setValue(0);
+}
+
+void ScoreCounter::setValue(int newValue)
+{
+    if (newValue == value)
+        return;
+    value = newValue;
+
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits) - 1, value);
+    *result.ptr = '\0';
+    shadow.setString(digits);
+    text.setString(digits);
+}
+
+void ScoreCounter::setPosition(sf::Vector2f position, sf::Vector2f shadowOffset)
+{
+    text.setPosition(position);
+    shadow.setPosition(position + shadowOffset);
+}
+
+void ScoreCounter::draw(sf::RenderTarget &target) const
+{
+    target.draw(shadow);
+    target.draw(text);
+}
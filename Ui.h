@@ -0,0 +1,91 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <initializer_list>
+#include <string>
+
+// UI constants
+const sf::Color HOVER_COLOR = sf::Color(255, 200, 87);
+const sf::Color TEXT_COLOR = sf::Color::White;
+const sf::Color SECONDARY_TEXT_COLOR = sf::Color(200, 220, 255);
+const sf::Color ACCENT_COLOR = sf::Color(0, 255, 150);
+const sf::Color BUTTON_BG_COLOR = sf::Color(40, 50, 80);
+
+const int BUTTON_WIDTH = 120;
+const int BUTTON_HEIGHT = 50;
+const int BUTTON_SPACING = 20;
+const int PADDING = 20;
+
+// Retained-mode UI widgets. Each widget builds its text and shapes once and only
+// re-measures or re-positions them when its string, position or state changes.
+
+// Load the glyphs of every digit at the given sizes so the first score change does not hitch
+void prewarmDigitGlyphs(const sf::Font &font, std::initializer_list<unsigned int> sizes);
+
+class Label
+{
+public:
+    Label(const sf::Font &font, const std::string &string, unsigned int size, sf::Color color);
+
+    void setString(const std::string &string);
+    void setNumber(int value);
+
+    // Left-aligned at a position
+    void setPosition(sf::Vector2f position);
+
+    // Horizontally centred within [0, width) at a given y
+    void setCentered(float width, float y);
+
+    void draw(sf::RenderTarget &target);
+
+private:
+    void layout();
+
+    sf::Text text;
+    std::string current;
+    sf::Vector2f anchor;
+    float centerWidth = 0;
+    bool centered = false;
+    bool dirty = true;
+};
+
+class Button
+{
+public:
+    Button(const sf::Font &font, const std::string &label, sf::Vector2f position, sf::Vector2f size, unsigned int fontSize);
+
+    // Update hover state from the mouse position; only restyles when hover changes, and returns whether it did
+    bool setHovered(bool hovered);
+    bool updateHover(sf::Vector2f mousePos) { return setHovered(bounds.contains(mousePos)); }
+
+    bool contains(sf::Vector2f point) const { return bounds.contains(point); }
+
+    void setLabel(const std::string &label);
+
+    void draw(sf::RenderTarget &target) const;
+
+private:
+    void restyle();
+    void centerText();
+
+    sf::RectangleShape background;
+    sf::Text text;
+    sf::FloatRect bounds;
+    bool hovered = false;
+};
+
+// Score readout with a drop shadow; the strings are only rebuilt when the value changes
+class ScoreCounter
+{
+public:
+    ScoreCounter(const sf::Font &font, unsigned int size, sf::Color color, sf::Color shadowColor);
+
+    void setValue(int value);
+    void setPosition(sf::Vector2f position, sf::Vector2f shadowOffset);
+
+    void draw(sf::RenderTarget &target) const;
+
+private:
+    sf::Text shadow;
+    sf::Text text;
+    int value = -1;
+};
@@ -0,0 +1,181 @@
+#include "VecEnv.h"
+#include <algorithm>
+#include <cmath>
+
+void writeObservation(const GameSim &sim, float *observation)
+{
+    observation[0] = sim.x / WINDOW_WIDTH;
+    observation[1] = sim.y / WINDOW_HEIGHT;
+    observation[2] = (sim.x - sim.prevX) / (sim.params.playerSpeed * sim.params.timeStep);
+    observation[3] = sim.dy / sim.params.jumpPower;
+
+    // Platforms are ordered by height, so the nearest ones surround the first one above the feet
+    float feetY = sim.y + PLAYER_HEIGHT;
+    float playerCenter = sim.x + PLAYER_WIDTH / 2;
+    int above = sim.platforms.firstAbove((int)std::ceil(feetY));
+    int below = above - 1;
+    float *slot = observation + 4;
+    for (int n = 0; n < ENV_OBS_PLATFORMS; n++, slot += 3)
+    {
+        bool haveAbove = above < sim.platforms.size();
+        bool haveBelow = below >= 0;
+        if (!haveAbove && !haveBelow)
+        {
+            slot[0] = slot[1] = slot[2] = 0;
+            continue;
+        }
+
+        int i = above;
+        if (!haveAbove || (haveBelow && sim.platforms.y(below) - feetY < feetY - sim.platforms.y(above)))
+            i = below--;
+        else
+            above++;
+
+        slot[0] = (sim.platforms.x(i) + PLATFORM_WIDTH / 2 - playerCenter) / WINDOW_WIDTH;
+        slot[1] = (sim.platforms.y(i) - feetY) / WINDOW_HEIGHT;
+        slot[2] = 1;
+    }
+}
+
+VecEnv::VecEnv(int count, std::uint64_t seed, unsigned int threads, int maxTicks, const GameParams &params)
+    : episodes(count, 0), lastScores(count, 0), baseSeed(seed), maxTicks(maxTicks)
+{
+    games.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        games.emplace_back(episodeSeed(i), params);
+    }
+
+    // Split the batch evenly over the threads, but no finer than ENV_MIN_TASK_SIZE
+    threads = std::max(1u, threads);
+    taskSize = std::max(ENV_MIN_TASK_SIZE, (count + (int)threads - 1) / (int)threads);
+    int ranges = (count + taskSize - 1) / taskSize;
+    try
+    {
+        for (int range = 1; range < ranges; range++)
+        {
+            workers.emplace_back(&VecEnv::workerLoop, this, range);
+        }
+    }
+    catch (...)
+    {
+        // The destructor does not run for a failed constructor, so stop the workers already started
+        stopWorkers();
+        throw;
+    }
+}
+
+VecEnv::~VecEnv()
+{
+    stopWorkers();
+}
+
+void VecEnv::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(stepMutex);
+        stopping = true;
+    }
+    stepStarted.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void VecEnv::workerLoop(int range)
+{
+    std::uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stepMutex);
+            stepStarted.wait(lock, [&]()
+                             { return stopping || stepGeneration != seen; });
+            if (stopping)
+                return;
+            seen = stepGeneration;
+        }
+
+        int begin = range * taskSize;
+        stepRange(begin, std::min(size(), begin + taskSize));
+
+        std::lock_guard<std::mutex> lock(stepMutex);
+        if (--busyWorkers == 0)
+            stepFinished.notify_one();
+    }
+}
+
+std::uint64_t VecEnv::episodeSeed(int index)
+{
+    Rng mixer;
+    mixer.seed(baseSeed * 0x9E3779B97F4A7C15ULL + ((std::uint64_t)index << 32) + episodes[index]);
+    return ((std::uint64_t)mixer.next() << 32) | mixer.next();
+}
+
+void VecEnv::reset(const std::uint64_t *seeds, float *observations)
+{
+    for (int i = 0; i < size(); i++)
+    {
+        if (!seeds)
+            episodes[i] = 0;
+        resetOne(i, seeds ? seeds[i] : episodeSeed(i), observations ? observations + (size_t)i * ENV_OBS_SIZE : nullptr);
+    }
+}
+
+void VecEnv::resetOne(int index, std::uint64_t seed, float *observation)
+{
+    games[index].reset(seed);
+    if (observation)
+        writeObservation(games[index], observation);
+}
+
+void VecEnv::step(const std::uint8_t *actions, float *observations, float *rewards, std::uint8_t *dones)
+{
+    stepActions = actions;
+    stepObservations = observations;
+    stepRewards = rewards;
+    stepDones = dones;
+
+    if (workers.empty())
+    {
+        stepRange(0, size());
+        return;
+    }
+
+    // Fork: every worker sees the new generation and steps its own range
+    {
+        std::lock_guard<std::mutex> lock(stepMutex);
+        stepGeneration++;
+        busyWorkers = (int)workers.size();
+    }
+    stepStarted.notify_all();
+
+    stepRange(0, std::min(size(), taskSize));
+
+    // Join: the last worker to finish wakes the caller
+    std::unique_lock<std::mutex> lock(stepMutex);
+    stepFinished.wait(lock, [&]()
+                      { return busyWorkers == 0; });
+}
+
+void VecEnv::stepRange(int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        GameSim &sim = games[i];
+        int scoreBefore = sim.currentScore;
+        sim.step(maskToInput(stepActions[i]));
+
+        bool done = sim.gameOver || (maxTicks > 0 && sim.frameCounter >= maxTicks);
+        stepRewards[i] = (float)(sim.currentScore - scoreBefore);
+        stepDones[i] = done ? 1 : 0;
+        if (done)
+        {
+            lastScores[i] = sim.currentScore;
+            episodes[i]++;
+            sim.reset(episodeSeed(i));
+        }
+        writeObservation(sim, stepObservations + (size_t)i * ENV_OBS_SIZE);
+    }
+}
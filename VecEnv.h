@@ -0,0 +1,90 @@
+#pragma once
+#include "GameSim.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Platforms described in each observation, nearest to the player's feet first
+const int ENV_OBS_PLATFORMS = 5;
+
+// Floats per observation:
+//   0  player x / WINDOW_WIDTH
+//   1  player y / WINDOW_HEIGHT
+//   2  horizontal velocity this step / (player speed * time step)
+//   3  vertical velocity / jump power
+//   then per platform: x offset from the player's centre / WINDOW_WIDTH,
+//   y offset from the player's feet / WINDOW_HEIGHT, and 1 if present (0 pads missing ones)
+const int ENV_OBS_SIZE = 4 + 3 * ENV_OBS_PLATFORMS;
+
+// Environments stepped per thread at least, so small batches are not swamped by waking workers
+const int ENV_MIN_TASK_SIZE = 256;
+
+// A batch of independent games stepped together for reinforcement learning.
+//
+// step() applies one action per game, split into fixed ranges over worker
+// threads started with the batch, and writes the observations, rewards (score gained this tick) and done flags straight into
+// the caller's arrays, which are indexed by game. A game that ends is reset at
+// once with its next seed and the observation written is the new game's first;
+// the done flag and episodeScore() report the game that ended. Seeds for
+// automatic resets depend only on the base seed, the game index and how many
+// games it has played, so a run is reproducible regardless of thread count.
+// A step hands the workers a generation number and counts them back in, so it
+// allocates nothing and queues nothing.
+class VecEnv
+{
+public:
+    // maxTicks > 0 also ends games that run that long
+    VecEnv(int count, std::uint64_t seed, unsigned int threads = std::thread::hardware_concurrency(),
+           int maxTicks = 0, const GameParams &params = GameParams());
+    ~VecEnv();
+
+    VecEnv(const VecEnv &) = delete;
+    VecEnv &operator=(const VecEnv &) = delete;
+
+    int size() const { return (int)games.size(); }
+
+    // Restart every game, from the given seeds or (if null) from the base seed, and write first observations
+    void reset(const std::uint64_t *seeds, float *observations);
+
+    // Restart one game from a seed; observation may be null
+    void resetOne(int index, std::uint64_t seed, float *observation);
+
+    // Advance every game by one tick. actions holds INPUT_LEFT/INPUT_RIGHT masks.
+    void step(const std::uint8_t *actions, float *observations, float *rewards, std::uint8_t *dones);
+
+    // Final score of the most recent game that ended at an index
+    int episodeScore(int index) const { return lastScores[index]; }
+
+private:
+    void stepRange(int begin, int end);
+    void workerLoop(int range);
+    void stopWorkers();
+    std::uint64_t episodeSeed(int index);
+
+    std::vector<GameSim> games;
+    std::vector<std::uint32_t> episodes;
+    std::vector<int> lastScores;
+    std::uint64_t baseSeed;
+    int maxTicks;
+    int taskSize;
+
+    // Worker w steps range w + 1; the calling thread steps range 0
+    std::vector<std::thread> workers;
+    std::mutex stepMutex;
+    std::condition_variable stepStarted;
+    std::condition_variable stepFinished;
+    std::uint64_t stepGeneration = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+
+    // Caller buffers for the step in progress
+    const std::uint8_t *stepActions = nullptr;
+    float *stepObservations = nullptr;
+    float *stepRewards = nullptr;
+    std::uint8_t *stepDones = nullptr;
+};
+
+// Write one game's observation in the ENV_OBS_SIZE layout
+void writeObservation(const GameSim &sim, float *observation);